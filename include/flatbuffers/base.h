@@ -265,6 +265,19 @@ namespace flatbuffers {
   #endif
 #endif // !FLATBUFFERS_HAS_NEW_STRTOD
 
+#ifndef FLATBUFFERS_HAS_FLOAT_CHARCONV
+  // std::from_chars and std::to_chars for floating-point numbers (C++17).
+  // They are locale independent, and much faster than strtod/stringstream.
+  #if defined(__has_include)
+    #if __has_include(<charconv>) && (__cplusplus >= 201703L || (defined(_HAS_CXX17) && _HAS_CXX17))
+      #include <charconv>
+      #if defined(__cpp_lib_to_chars) && (__cpp_lib_to_chars >= 201611L)
+        #define FLATBUFFERS_HAS_FLOAT_CHARCONV 1
+      #endif
+    #endif
+  #endif
+#endif // !FLATBUFFERS_HAS_FLOAT_CHARCONV
+
 #ifndef FLATBUFFERS_LOCALE_INDEPENDENT
   // Enable locale independent functions {strtof_l, strtod_l,strtoll_l,
   // strtoull_l} on platforms that support them.
@@ -447,6 +460,35 @@ template<typename T> FLATBUFFERS_SUPPRESS_UBSAN("alignment") void WriteScalar(vo
   *reinterpret_cast<uoffset_t *>(p) = EndianScalar(t.o);
 }
 
+// Copies `count` scalars from `src` to `dst`, reversing the byte order of each.
+// This is written as a plain byte shuffle so compilers can vectorize it.
+template<typename T>
+void EndianSwapCopy(T *dst, const T *src, size_t count) {
+  auto d = reinterpret_cast<uint8_t *>(dst);
+  auto s = reinterpret_cast<const uint8_t *>(src);
+  const size_t num_bytes = count * sizeof(T);
+  for (size_t i = 0; i < num_bytes; i += sizeof(T)) {
+    for (size_t j = 0; j < sizeof(T); j++) {
+      d[i + j] = s[i + sizeof(T) - 1 - j];
+    }
+  }
+}
+
+// Bulk version of EndianScalar(): copies `count` scalars from `src` to `dst`,
+// converting between native and little endian byte order.
+template<typename T>
+void EndianScalarCopy(T *dst, const T *src, size_t count) {
+  #if FLATBUFFERS_LITTLEENDIAN
+    memcpy(dst, src, count * sizeof(T));
+  #else
+    if (sizeof(T) == 1) {
+      memcpy(dst, src, count);
+    } else {
+      EndianSwapCopy(dst, src, count);
+    }
+  #endif
+}
+
 #if (FLATBUFFERS_GCC >= 100000) && (FLATBUFFERS_GCC < 110000)
   #pragma GCC diagnostic pop
 #endif
@@ -88,12 +88,39 @@ FLATBUFFERS_CONSTEXPR size_t AlignOf() {
   // clang-format on
 }
 
+// Lexicographically compare two strings (possibly containing nulls), and
+// return a value less than, equal to, or greater than zero, like memcmp.
+// Strings that differ in their first 8 bytes are ordered with a single word
+// compare, the rest is left to memcmp, which the C library vectorizes.
+static inline int StringCompare(const char* a_data, size_t a_size,
+                                const char* b_data, size_t b_size) {
+  const size_t size = (std::min)(a_size, b_size);
+  size_t prefix = 0;
+  if (size >= sizeof(uint64_t)) {
+    uint64_t a_word;
+    uint64_t b_word;
+    memcpy(&a_word, a_data, sizeof(a_word));
+    memcpy(&b_word, b_data, sizeof(b_word));
+    if (a_word != b_word) {
+      // As big endian numbers, words order like their bytes.
+#if FLATBUFFERS_LITTLEENDIAN
+      a_word = EndianSwap(a_word);
+      b_word = EndianSwap(b_word);
+#endif
+      return a_word < b_word ? -1 : 1;
+    }
+    prefix = sizeof(uint64_t);
+  }
+  const auto cmp = memcmp(a_data + prefix, b_data + prefix, size - prefix);
+  if (cmp) return cmp;
+  return static_cast<int>(a_size > b_size) - static_cast<int>(a_size < b_size);
+}
+
 // Lexicographically compare two strings (possibly containing nulls), and
 // return true if the first is less than the second.
 static inline bool StringLessThan(const char* a_data, uoffset_t a_size,
                                   const char* b_data, uoffset_t b_size) {
-  const auto cmp = memcmp(a_data, b_data, (std::min)(a_size, b_size));
-  return cmp == 0 ? a_size < b_size : cmp < 0;
+  return StringCompare(a_data, a_size, b_data, b_size) < 0;
 }
 
 // When we read serialized data from memory, in the case of most scalars,
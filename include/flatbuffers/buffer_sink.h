@@ -0,0 +1,125 @@
+/*
+ * Copyright 2024 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLATBUFFERS_BUFFER_SINK_H_
+#define FLATBUFFERS_BUFFER_SINK_H_
+
+#include <cerrno>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#include "flatbuffers/base.h"
+
+#ifdef _WIN32
+#  include <io.h>
+#else
+#  include <unistd.h>
+#endif
+
+namespace flatbuffers {
+
+// Receives the parts of a buffer that a streaming FlatBufferBuilder no longer
+// keeps in memory, see FlatBufferBuilder::StreamTo().
+class BufferSink {
+ public:
+  virtual ~BufferSink() {}
+
+  // Appends `len` bytes to the output. Returns false on failure.
+  virtual bool Write(const uint8_t* data, size_t len) = 0;
+};
+
+// Appends to a file opened in binary mode.
+class FileBufferSink : public BufferSink {
+ public:
+  explicit FileBufferSink(FILE* file) : file_(file) {}
+
+  bool Write(const uint8_t* data, size_t len) FLATBUFFERS_OVERRIDE {
+    return fwrite(data, 1, len, file_) == len;
+  }
+
+ private:
+  FILE* file_;
+};
+
+// Appends to a file descriptor, such as a pipe or a socket.
+class FdBufferSink : public BufferSink {
+ public:
+  explicit FdBufferSink(int fd) : fd_(fd) {}
+
+  bool Write(const uint8_t* data, size_t len) FLATBUFFERS_OVERRIDE {
+    while (len) {
+      // clang-format off
+      #ifdef _WIN32
+        const auto chunk = (std::min)(len, size_t(1) << 30);
+        const auto written = _write(fd_, data, static_cast<unsigned>(chunk));
+      #else
+        const auto written = write(fd_, data, len);
+      #endif
+      // clang-format on
+      if (written < 0) {
+        if (errno == EINTR) continue;
+        return false;
+      }
+      data += written;
+      len -= static_cast<size_t>(written);
+    }
+    return true;
+  }
+
+ private:
+  int fd_;
+};
+
+// Hands each part to a function.
+class CallbackBufferSink : public BufferSink {
+ public:
+  typedef std::function<bool(const uint8_t* data, size_t len)> Callback;
+
+  explicit CallbackBufferSink(Callback callback)
+      : callback_(std::move(callback)) {}
+
+  bool Write(const uint8_t* data, size_t len) FLATBUFFERS_OVERRIDE {
+    return callback_(data, len);
+  }
+
+ private:
+  Callback callback_;
+};
+
+// Describes where one part of a streamed buffer went. FlatBuffers are built
+// back to front, so the sink receives the end of the buffer first.
+struct BufferSegment {
+  // Where the part starts in the output of the sink.
+  size_t sink_offset;
+  // Where the part starts in the finished buffer.
+  size_t buffer_offset;
+  size_t size;
+};
+
+// Puts the parts of a streamed buffer in order, copying them from the output
+// of the sink (`sink_data`) to `buf`, which must hold the finished buffer.
+inline void AssembleBufferSegments(const uint8_t* sink_data,
+                                   const std::vector<BufferSegment>& segments,
+                                   uint8_t* buf) {
+  for (auto it = segments.begin(); it != segments.end(); ++it) {
+    memcpy(buf + it->buffer_offset, sink_data + it->sink_offset, it->size);
+  }
+}
+
+}  // namespace flatbuffers
+
+#endif  // FLATBUFFERS_BUFFER_SINK_H_
@@ -18,9 +18,12 @@
 #define FLATBUFFERS_FILE_MANAGER_H_
 
 #include <cstddef>
+#include <functional>
 #include <set>
 #include <string>
 
+#include "flatbuffers/buffer_sink.h"
+
 namespace flatbuffers {
 
 // A File interface to write data to file by default or
@@ -37,6 +40,19 @@ class FileSaver {
     return SaveFile(name, buf.c_str(), buf.size(), binary);
   }
 
+  // Saves a file whose contents `write` produces in parts, returning false if
+  // it fails. By default the parts are collected and passed to SaveFile();
+  // savers that write to disk save the parts as they come instead.
+  typedef std::function<bool(BufferSink& sink)> Writer;
+  virtual bool SaveFile(const char* name, bool binary, const Writer& write) {
+    std::string buf;
+    CallbackBufferSink sink([&](const uint8_t* data, size_t len) {
+      buf.append(reinterpret_cast<const char*>(data), len);
+      return true;
+    });
+    return write(sink) && SaveFile(name, buf, binary);
+  }
+
   virtual void Finish() {}
 
  private:
@@ -50,12 +66,18 @@ class FileSaver {
 
 class RealFileSaver final : public FileSaver {
  public:
+  using FileSaver::SaveFile;
+
   bool SaveFile(const char* name, const char* buf, size_t len,
                 bool binary) final;
+
+  bool SaveFile(const char* name, bool binary, const Writer& write) final;
 };
 
 class FileNameSaver final : public FileSaver {
  public:
+  using FileSaver::SaveFile;
+
   bool SaveFile(const char* name, const char* buf, size_t len,
                 bool binary) final;
 
@@ -28,6 +28,7 @@
 #include "flatbuffers/base.h"
 #include "flatbuffers/buffer.h"
 #include "flatbuffers/buffer_ref.h"
+#include "flatbuffers/buffer_sink.h"
 #include "flatbuffers/default_allocator.h"
 #include "flatbuffers/detached_buffer.h"
 #include "flatbuffers/stl_emulation.h"
@@ -108,7 +109,13 @@ class FlatBufferBuilderImpl {
         minalign_(1),
         force_defaults_(false),
         dedup_vtables_(true),
-        string_pool(nullptr) {
+        hash_vtables_(false),
+        num_vtables_(0),
+        vtable_index_size_(0),
+        num_pooled_strings_(0),
+        string_pool_size_(0),
+        fixed_vtable_(nullptr),
+        fixed_vtable_offset_(0) {
     EndianCheck();
   }
 
@@ -125,7 +132,13 @@ class FlatBufferBuilderImpl {
         minalign_(1),
         force_defaults_(false),
         dedup_vtables_(true),
-        string_pool(nullptr) {
+        hash_vtables_(false),
+        num_vtables_(0),
+        vtable_index_size_(0),
+        num_pooled_strings_(0),
+        string_pool_size_(0),
+        fixed_vtable_(nullptr),
+        fixed_vtable_offset_(0) {
     EndianCheck();
     // Default construct and swap idiom.
     // Lack of delegating constructors in vs2010 makes it more verbose than
@@ -152,11 +165,13 @@ class FlatBufferBuilderImpl {
     swap(minalign_, other.minalign_);
     swap(force_defaults_, other.force_defaults_);
     swap(dedup_vtables_, other.dedup_vtables_);
-    swap(string_pool, other.string_pool);
-  }
-
-  ~FlatBufferBuilderImpl() {
-    if (string_pool) delete string_pool;
+    swap(hash_vtables_, other.hash_vtables_);
+    swap(num_vtables_, other.num_vtables_);
+    swap(vtable_index_size_, other.vtable_index_size_);
+    swap(num_pooled_strings_, other.num_pooled_strings_);
+    swap(string_pool_size_, other.string_pool_size_);
+    swap(fixed_vtable_, other.fixed_vtable_);
+    swap(fixed_vtable_offset_, other.fixed_vtable_offset_);
   }
 
   void Reset() {
@@ -173,7 +188,8 @@ class FlatBufferBuilderImpl {
     finished = false;
     minalign_ = 1;
     length_of_64_bit_region_ = 0;
-    if (string_pool) string_pool->clear();
+    ClearScratchIndices();
+    fixed_vtable_ = nullptr;
   }
 
   /// @brief The current size of the serialized buffer, counting from the end.
@@ -203,19 +219,29 @@ class FlatBufferBuilderImpl {
     return static_cast<uoffset_t>(GetSize());
   }
 
+  /// @brief The number of bytes allocated for the buffer, including space not
+  /// yet in use. This is kept across `Clear()`, and released by `Reset()`.
+  size_t GetCapacity() const { return buf_.capacity(); }
+
   /// @brief Get the serialized buffer (after you call `Finish()`).
+  /// Not valid for a buffer streamed with `StreamTo()`, most of which is no
+  /// longer in memory.
   /// @return Returns an `uint8_t` pointer to the FlatBuffer data inside the
   /// buffer.
   uint8_t* GetBufferPointer() const {
     Finished();
+    // Use ReleaseSegments() for a streamed buffer.
+    FLATBUFFERS_ASSERT(!buf_.flushed());
     return buf_.data();
   }
 
   /// @brief Get the serialized buffer (after you call `Finish()`) as a span.
+  /// Not valid for a buffer streamed with `StreamTo()`.
   /// @return Returns a constructed flatbuffers::span that is a view over the
   /// FlatBuffer data inside the buffer.
   flatbuffers::span<uint8_t> GetBufferSpan() const {
     Finished();
+    FLATBUFFERS_ASSERT(!buf_.flushed());
     return flatbuffers::span<uint8_t>(buf_.data(), buf_.size());
   }
 
@@ -232,6 +258,54 @@ class FlatBufferBuilderImpl {
     return buffer;
   }
 
+  /// @brief Write the buffer to `sink` while it is being built, rather than
+  /// keeping all of it in memory. Whenever the buffer runs out of space, the
+  /// data built so far (which makes up the end of the finished buffer) is
+  /// passed to the sink instead of growing the buffer. Memory use then stays
+  /// around the initial size of the builder, plus whatever the largest single
+  /// table, string or vector needs.
+  /// Must be called before building anything. Vtables and shared strings are
+  /// only deduplicated against those still in memory, and tables passed to
+  /// `Required()` or `CreateVectorOfSortedTables()` must still be in memory.
+  /// Pointers into the buffer, such as those returned by
+  /// `StartVectorOfStructs()` or `CreateUninitializedVector()`, are
+  /// invalidated by the next write to the builder, which may flush the data
+  /// they point to.
+  /// After `Finish()`, use `ReleaseSegments()` rather than `Release()`,
+  /// `GetBufferPointer()` or `GetBufferSpan()`, and the builder can't be
+  /// passed to `Splice()`.
+  /// @param[in] sink Where to write the buffer, or `nullptr` to stop
+  /// streaming. Must outlive the builder, or the next call.
+  void StreamTo(BufferSink* sink) {
+    FLATBUFFERS_ASSERT(!GetSize());
+    buf_.set_sink(sink);
+  }
+
+  /// @brief Write the rest of a streamed buffer (after you call `Finish()`) to
+  /// the sink, and clear the builder so it can be reused.
+  /// @param[out] segments Where each part written to the sink belongs in the
+  /// finished buffer, in the order they were written. See
+  /// `AssembleBufferSegments()`.
+  /// @return Returns `false` if the sink failed to write any part.
+  bool ReleaseSegments(std::vector<BufferSegment>* segments) {
+    Finished();
+    const SizeT size = GetSize();
+    buf_.flush(size);
+    const std::vector<size_t>& sizes = buf_.flushed_segments();
+    segments->clear();
+    size_t sink_offset = 0;
+    for (size_t i = 0; i < sizes.size(); i++) {
+      const BufferSegment segment = { sink_offset,
+                                      size - sink_offset - sizes[i],
+                                      sizes[i] };
+      segments->push_back(segment);
+      sink_offset += sizes[i];
+    }
+    const bool ok = !buf_.sink_failed();
+    Clear();
+    return ok;
+  }
+
   /// @brief Get the released pointer to the serialized buffer.
   /// @param size The size of the memory block containing
   /// the serialized `FlatBuffer`.
@@ -280,6 +354,18 @@ class FlatBufferBuilderImpl {
   /// @param[in] dedup When set to `true`, dedup vtables.
   void DedupVtables(bool dedup) { dedup_vtables_ = dedup; }
 
+  /// @brief Vtable deduplication does a linear scan over all vtables written
+  /// so far, which gets slow for buffers with many distinct table layouts.
+  /// This instead keeps them in a hash index stored in the scratch area of the
+  /// buffer, making each lookup O(1). The output is identical either way.
+  /// Must be set before the first table is built.
+  /// @param[in] hash When set to `true`, use a hashed vtable index.
+  void HashVtables(bool hash) {
+    // If you hit this, tables have already been built with the other mode.
+    FLATBUFFERS_ASSERT(buf_.scratch_size() == StringPoolBytes());
+    hash_vtables_ = hash;
+  }
+
   /// @cond FLATBUFFERS_INTERNAL
   void Pad(size_t num_bytes) { buf_.fill(num_bytes); }
 
@@ -420,6 +506,8 @@ class FlatBufferBuilderImpl {
   uoffset_t StartTable() {
     NotNested();
     nested = true;
+    // A streaming buffer must keep the table in memory until it is done.
+    buf_.set_flush_limit(GetSize());
     return GetSizeRelative32BitRegion();
   }
 
@@ -464,24 +552,19 @@ class FlatBufferBuilderImpl {
     auto vt1 = reinterpret_cast<voffset_t*>(buf_.data());
     auto vt1_size = ReadScalar<voffset_t>(vt1);
     auto vt_use = GetSizeRelative32BitRegion();
+    const uint32_t vt1_hash = hash_vtables_ ? HashBytes(vt1, vt1_size) : 0;
     // See if we already have generated a vtable with this exact same
     // layout before. If so, make it point to the old one, remove this one.
     if (dedup_vtables_) {
-      for (auto it = buf_.scratch_data(); it < buf_.scratch_end();
-           it += sizeof(uoffset_t)) {
-        auto vt_offset_ptr = reinterpret_cast<uoffset_t*>(it);
-        auto vt2 = reinterpret_cast<voffset_t*>(
-            buf_.data_at(*vt_offset_ptr + length_of_64_bit_region_));
-        auto vt2_size = ReadScalar<voffset_t>(vt2);
-        if (vt1_size != vt2_size || 0 != memcmp(vt2, vt1, vt1_size)) continue;
-        vt_use = *vt_offset_ptr;
+      const uoffset_t vt2_offset = FindExistingVtable(vt1, vt1_size, vt1_hash);
+      if (vt2_offset) {
+        vt_use = vt2_offset;
         buf_.pop(GetSizeRelative32BitRegion() - vtable_offset_loc);
-        break;
       }
     }
     // If this is a new vtable, remember it.
     if (vt_use == GetSizeRelative32BitRegion()) {
-      buf_.scratch_push_small(vt_use);
+      RememberVtable(vt_use, vt1_hash);
     }
     // Fill the vtable offset we created above.
     // The offset points from the beginning of the object to where the vtable is
@@ -491,6 +574,7 @@ class FlatBufferBuilderImpl {
     WriteScalar(buf_.data_at(vtable_offset_loc + length_of_64_bit_region_),
                 static_cast<soffset_t>(vt_use) -
                     static_cast<soffset_t>(vtable_offset_loc));
+    buf_.clear_flush_limit();
     nested = false;
     return vtable_offset_loc;
   }
@@ -500,6 +584,69 @@ class FlatBufferBuilderImpl {
     return EndTable(start);
   }
 
+  // These build a table whose layout was worked out ahead of time, as done by
+  // the CreateXFixed functions generated with `flatc --gen-fixed-create`.
+  // Rather than adding fields one by one, the caller writes them at fixed
+  // offsets into the `object_size` bytes following the vtable offset, starting
+  // at GetCurrentBufferPointer(). The table is aligned to `alignment`, which
+  // must be at least that of its fields and of uoffset_t.
+  uoffset_t StartFixedTable(size_t object_size, size_t alignment) {
+    NotNested();
+    nested = true;
+    Align(alignment);
+    buf_.set_flush_limit(GetSize());
+    buf_.fill_big(object_size);
+    return GetSizeRelative32BitRegion();
+  }
+
+  // Writes an offset to `off` into the field at `field` bytes into the table
+  // `start`, as returned by StartFixedTable.
+  template <typename T>
+  void SetFixedOffset(uoffset_t start, voffset_t field, Offset<T> off) {
+    // Every field of a fixed table is present, so offsets can't be null.
+    FLATBUFFERS_ASSERT(!off.IsNull());
+    const uoffset_t field_loc = start - field;
+    FLATBUFFERS_ASSERT(off.o < field_loc);
+    WriteScalar(buf_.data_at(field_loc + length_of_64_bit_region_),
+                field_loc - off.o);
+  }
+
+  // Finishes the table `start` with `vtable`, which must stay valid and
+  // unchanged while this builder is in use. The offset of the vtable in the
+  // buffer is kept with it, so building many tables with the same vtable in a
+  // row skips both writing it and the dedup scan.
+  uoffset_t EndFixedTable(uoffset_t start, const voffset_t* vtable) {
+    FLATBUFFERS_ASSERT(nested);
+    FLATBUFFERS_ASSERT(!num_field_loc);
+    uoffset_t vt_use;
+    if (dedup_vtables_ && vtable == fixed_vtable_) {
+      vt_use = fixed_vtable_offset_;
+    } else {
+      const voffset_t vt_size = vtable[0];
+      auto vt = reinterpret_cast<voffset_t*>(buf_.make_space(vt_size));
+      for (size_t i = 0; i < vt_size / sizeof(voffset_t); i++) {
+        WriteScalar(vt + i, vtable[i]);
+      }
+      vt_use = GetSizeRelative32BitRegion();
+      const uint32_t hash = hash_vtables_ ? HashBytes(vt, vt_size) : 0;
+      const uoffset_t existing =
+          dedup_vtables_ ? FindExistingVtable(vt, vt_size, hash) : 0;
+      if (existing) {
+        vt_use = existing;
+        buf_.pop(vt_size);
+      } else {
+        RememberVtable(vt_use, hash);
+      }
+      fixed_vtable_ = vtable;
+      fixed_vtable_offset_ = vt_use;
+    }
+    WriteScalar(buf_.data_at(start + length_of_64_bit_region_),
+                static_cast<soffset_t>(vt_use) - static_cast<soffset_t>(start));
+    buf_.clear_flush_limit();
+    nested = false;
+    return start;
+  }
+
   // This checks a required field has been set in a given table that has
   // just been constructed.
   template <typename T>
@@ -610,38 +757,30 @@ class FlatBufferBuilderImpl {
 
   /// @brief Store a string in the buffer, which can contain any binary data.
   /// If a string with this exact contents has already been serialized before,
-  /// instead simply returns the offset of the existing string. This uses a map
-  /// stored on the heap, but only stores the numerical offsets.
+  /// instead simply returns the offset of the existing string. This uses a hash
+  /// table kept in the scratch area of the buffer, which only stores the
+  /// numerical offsets.
   /// @param[in] str A const char pointer to the data to be stored as a string.
   /// @param[in] len The number of bytes that should be stored from `str`.
   /// @return Returns the offset in the buffer where the string starts.
   Offset<String> CreateSharedString(const char* str, size_t len) {
-    FLATBUFFERS_ASSERT(FLATBUFFERS_GENERAL_HEAP_ALLOC_OK);
-    if (!string_pool) {
-      string_pool = new StringOffsetMap(StringOffsetCompare(buf_));
-    }
-
-    const size_t size_before_string = buf_.size();
-    // Must first serialize the string, since the set is all offsets into
-    // buffer.
-    const Offset<String> off = CreateString<Offset>(str, len);
-    auto it = string_pool->find(off);
+    NotNested();
+    const uint32_t hash = HashBytes(str, len);
     // If it exists we reuse existing serialized data!
-    if (it != string_pool->end()) {
-      // We can remove the string we serialized.
-      buf_.pop(buf_.size() - size_before_string);
-      return *it;
-    }
+    const uoffset_t existing = FindString(str, len, hash);
+    if (existing) return Offset<String>(existing);
+    const Offset<String> off = CreateString<Offset>(str, len);
     // Record this string for future use.
-    string_pool->insert(off);
+    InsertString(off.o, hash);
     return off;
   }
 
 #ifdef FLATBUFFERS_HAS_STRING_VIEW
   /// @brief Store a string in the buffer, which can contain any binary data.
   /// If a string with this exact contents has already been serialized before,
-  /// instead simply returns the offset of the existing string. This uses a map
-  /// stored on the heap, but only stores the numerical offsets.
+  /// instead simply returns the offset of the existing string. This uses a hash
+  /// table kept in the scratch area of the buffer, which only stores the
+  /// numerical offsets.
   /// @param[in] str A const std::string_view to store in the buffer.
   /// @return Returns the offset in the buffer where the string starts
   Offset<String> CreateSharedString(const flatbuffers::string_view str) {
@@ -650,8 +789,9 @@ class FlatBufferBuilderImpl {
 #else
   /// @brief Store a string in the buffer, which null-terminated.
   /// If a string with this exact contents has already been serialized before,
-  /// instead simply returns the offset of the existing string. This uses a map
-  /// stored on the heap, but only stores the numerical offsets.
+  /// instead simply returns the offset of the existing string. This uses a hash
+  /// table kept in the scratch area of the buffer, which only stores the
+  /// numerical offsets.
   /// @param[in] str A const char pointer to a C-string to add to the buffer.
   /// @return Returns the offset in the buffer where the string starts.
   Offset<String> CreateSharedString(const char* str) {
@@ -660,8 +800,9 @@ class FlatBufferBuilderImpl {
 
   /// @brief Store a string in the buffer, which can contain any binary data.
   /// If a string with this exact contents has already been serialized before,
-  /// instead simply returns the offset of the existing string. This uses a map
-  /// stored on the heap, but only stores the numerical offsets.
+  /// instead simply returns the offset of the existing string. This uses a hash
+  /// table kept in the scratch area of the buffer, which only stores the
+  /// numerical offsets.
   /// @param[in] str A const reference to a std::string to store in the buffer.
   /// @return Returns the offset in the buffer where the string starts.
   Offset<String> CreateSharedString(const std::string& str) {
@@ -671,8 +812,9 @@ class FlatBufferBuilderImpl {
 
   /// @brief Store a string in the buffer, which can contain any binary data.
   /// If a string with this exact contents has already been serialized before,
-  /// instead simply returns the offset of the existing string. This uses a map
-  /// stored on the heap, but only stores the numerical offsets.
+  /// instead simply returns the offset of the existing string. This uses a hash
+  /// table kept in the scratch area of the buffer, which only stores the
+  /// numerical offsets.
   /// @param[in] str A const pointer to a `String` struct to add to the buffer.
   /// @return Returns the offset in the buffer where the string starts
   Offset<String> CreateSharedString(const String* str) {
@@ -759,19 +901,9 @@ class FlatBufferBuilderImpl {
     AssertScalarT<T>();
     StartVector<T, OffsetT, LenT>(len);
     if (len > 0) {
-      // clang-format off
-      #if FLATBUFFERS_LITTLEENDIAN
-        PushBytes(reinterpret_cast<const uint8_t *>(v), len * sizeof(T));
-      #else
-        if (sizeof(T) == 1) {
-          PushBytes(reinterpret_cast<const uint8_t *>(v), len);
-        } else {
-          for (auto i = len; i > 0; ) {
-            PushElement(v[--i]);
-          }
-        }
-      #endif
-      // clang-format on
+      // A plain copy on little endian hosts, a bulk byte swap otherwise.
+      EndianScalarCopy(reinterpret_cast<T*>(buf_.make_space(len * sizeof(T))),
+                       v, len);
     }
     return OffsetT<VectorT<T>>(EndVector<LenT, offset_type>(len));
   }
@@ -1120,6 +1252,86 @@ class FlatBufferBuilderImpl {
     return CreateVectorOfStructs(v, len);
   }
 
+  /// @brief Serialize an array of structs into a FlatBuffer `vector` in
+  /// Eytzinger order, for lookups with `Vector::LookupByKeyEytzinger()`.
+  /// @tparam T The data type of the struct array elements.
+  /// @param[in] v A pointer to the array of type `T` to serialize into the
+  /// buffer as a `vector`. It is left sorted.
+  /// @param[in] len The number of elements to serialize.
+  /// @return Returns a typed `Offset` into the serialized data indicating
+  /// where the vector is stored.
+  template <typename T>
+  Offset<Vector<const T*>> CreateVectorOfEytzingerStructs(T* v, size_t len) {
+    std::stable_sort(v, v + len, StructKeyComparator<T>());
+    auto structs = StartVectorOfStructs<T>(len);
+    ForEachEytzingerIndex(len, [&](size_t i, size_t sorted_i) {
+      structs[i] = v[sorted_i];
+    });
+    return EndVectorOfStructs<T>(len);
+  }
+
+  /// @brief Serialize a `std::vector` of structs into a FlatBuffer `vector`
+  /// in Eytzinger order, for lookups with `Vector::LookupByKeyEytzinger()`.
+  /// @tparam T The data type of the `std::vector` struct elements.
+  /// @param[in] v A pointer to the `std::vector` of structs to serialize into
+  /// the buffer as a `vector`. It is left sorted.
+  /// @return Returns a typed `Offset` into the serialized data indicating
+  /// where the vector is stored.
+  template <typename T, typename Alloc = std::allocator<T>>
+  Offset<Vector<const T*>> CreateVectorOfEytzingerStructs(
+      std::vector<T, Alloc>* v) {
+    return CreateVectorOfEytzingerStructs(data(*v), v->size());
+  }
+
+  /// @brief Serialize a copy of a `std::vector` of structs into a FlatBuffer
+  /// `vector` in Eytzinger order, leaving `v` as it is.
+  /// @tparam T The data type of the `std::vector` struct elements.
+  /// @param[in] v A const reference to the `std::vector` of structs to
+  /// serialize into the buffer as a `vector`.
+  /// @return Returns a typed `Offset` into the serialized data indicating
+  /// where the vector is stored.
+  template <typename T, typename Alloc = std::allocator<T>>
+  Offset<Vector<const T*>> CreateVectorOfEytzingerStructs(
+      const std::vector<T, Alloc>& v) {
+    std::vector<T> sorted(v.begin(), v.end());
+    return CreateVectorOfEytzingerStructs(&sorted);
+  }
+
+  /// @brief Serialize a `std::vector` of native structs into a FlatBuffer
+  /// `vector` in Eytzinger order.
+  /// @tparam T The data type of the struct array elements.
+  /// @tparam S The data type of the `std::vector` native struct elements.
+  /// @param[in] v A const reference to the `std::vector` of structs to
+  /// serialize into the buffer as a `vector`.
+  /// @param[in] pack_func Pointer to a function to convert the native struct
+  /// to the FlatBuffer struct.
+  /// @return Returns a typed `Offset` into the serialized data indicating
+  /// where the vector is stored.
+  template <typename T, typename S, typename Alloc = std::allocator<S>>
+  Offset<Vector<const T*>> CreateVectorOfEytzingerNativeStructs(
+      const std::vector<S, Alloc>& v, T (*const pack_func)(const S&)) {
+    FLATBUFFERS_ASSERT(pack_func);
+    std::vector<T> packed;
+    packed.reserve(v.size());
+    for (const auto& s : v) packed.push_back(pack_func(s));
+    return CreateVectorOfEytzingerStructs(&packed);
+  }
+
+  /// @brief Serialize a `std::vector` of native structs into a FlatBuffer
+  /// `vector` in Eytzinger order.
+  /// @tparam T The data type of the struct array elements.
+  /// @tparam S The data type of the `std::vector` native struct elements.
+  /// @param[in] v A const reference to the `std::vector` of structs to
+  /// serialize into the buffer as a `vector`.
+  /// @return Returns a typed `Offset` into the serialized data indicating
+  /// where the vector is stored.
+  template <typename T, typename S, typename Alloc = std::allocator<S>>
+  Offset<Vector<const T*>> CreateVectorOfEytzingerNativeStructs(
+      const std::vector<S, Alloc>& v) {
+    extern T Pack(const S&);
+    return CreateVectorOfEytzingerNativeStructs<T, S>(v, Pack);
+  }
+
   /// @brief Serialize an array of native structs into a FlatBuffer `vector` in
   /// sorted order.
   /// @tparam T The data type of the struct array elements.
@@ -1186,6 +1398,55 @@ class FlatBufferBuilderImpl {
     return CreateVectorOfSortedTables(data(*v), v->size());
   }
 
+  /// @brief Serialize an array of `table` offsets as a `vector` in the buffer
+  /// in Eytzinger order, for lookups with `Vector::LookupByKeyEytzinger()`.
+  /// @tparam T The data type that the offset refers to.
+  /// @param[in] v An array of type `Offset<T>` that contains the `table`
+  /// offsets to store in the buffer. It is left sorted.
+  /// @param[in] len The number of elements to store in the `vector`.
+  /// @return Returns a typed `Offset` into the serialized data indicating
+  /// where the vector is stored.
+  template <typename T>
+  Offset<Vector<Offset<T>>> CreateVectorOfEytzingerTables(Offset<T>* v,
+                                                          size_t len) {
+    std::stable_sort(v, v + len, TableKeyComparator<T>(buf_));
+    std::vector<Offset<T>> elems(len);
+    ForEachEytzingerIndex(len, [&](size_t i, size_t sorted_i) {
+      elems[i] = v[sorted_i];
+    });
+    return CreateVector(elems);
+  }
+
+  /// @brief Serialize an array of `table` offsets as a `vector` in the buffer
+  /// in Eytzinger order, for lookups with `Vector::LookupByKeyEytzinger()`.
+  /// @tparam T The data type that the offset refers to.
+  /// @param[in] v An array of type `Offset<T>` that contains the `table`
+  /// offsets to store in the buffer. It is left sorted.
+  /// @return Returns a typed `Offset` into the serialized data indicating
+  /// where the vector is stored.
+  template <typename T, typename Alloc = std::allocator<T>>
+  Offset<Vector<Offset<T>>> CreateVectorOfEytzingerTables(
+      std::vector<Offset<T>, Alloc>* v) {
+    return CreateVectorOfEytzingerTables(data(*v), v->size());
+  }
+
+  /// @brief Serialize the `table` offsets returned by a function as a
+  /// `vector` in the buffer in Eytzinger order.
+  /// @tparam T The data type that the offset refers to.
+  /// @param[in] vector_size The number of elements to store in the `vector`.
+  /// @param[in] f A function that takes the current iteration 0..vector_size-1
+  /// and the state parameter returning the `Offset<T>` of each element.
+  /// @param[in] state State passed to f.
+  /// @return Returns a typed `Offset` into the serialized data indicating
+  /// where the vector is stored.
+  template <typename T, typename F, typename S>
+  Offset<Vector<Offset<T>>> CreateVectorOfEytzingerTables(size_t vector_size,
+                                                          F f, S* state) {
+    std::vector<Offset<T>> elems(vector_size);
+    for (size_t i = 0; i < vector_size; i++) elems[i] = f(i, state);
+    return CreateVectorOfEytzingerTables(&elems);
+  }
+
   /// @brief Specialized version of `CreateVector` for non-copying use cases.
   /// Write the data any time later to the returned buffer pointer `buf`.
   /// @param[in] len The number of elements to store in the `vector`.
@@ -1212,6 +1473,8 @@ class FlatBufferBuilderImpl {
 
   /// @brief Specialized version of `CreateVector` for non-copying use cases.
   /// Write the data any time later to the returned buffer pointer `buf`.
+  /// The data must be little endian, e.g. by writing it with
+  /// `EndianScalarCopy`.
   /// @tparam T The data type of the data that will be stored in the buffer
   /// as a `vector`.
   /// @param[in] len The number of elements to store in the `vector`.
@@ -1240,8 +1503,12 @@ class FlatBufferBuilderImpl {
     AssertScalarT<T>();
     AssertScalarT<U>();
     StartVector<T>(len);
-    for (auto i = len; i > 0;) {
-      PushElement(static_cast<T>(v[--i]));
+    if (len > 0) {
+      // Convert all elements in one pass, straight into the buffer.
+      T* elems = reinterpret_cast<T*>(buf_.make_space(len * sizeof(T)));
+      for (size_t i = 0; i < len; i++) {
+        WriteScalar(elems + i, static_cast<T>(v[i]));
+      }
     }
     return Offset<Vector<T>>(EndVector(len));
   }
@@ -1256,6 +1523,69 @@ class FlatBufferBuilderImpl {
         CalculateOffset<typename Offset<const T*>::offset_type>());
   }
 
+  /// @brief Copy everything serialized so far by another builder into this
+  /// one. This allows building independent parts of a buffer (e.g. the
+  /// elements of a large vector of tables) on multiple threads, each with its
+  /// own builder, and then combining them. All offsets inside FlatBuffers are
+  /// relative, so the data is copied as-is. Vtables and strings pooled with
+  /// `CreateSharedString` in `other` are remembered, so that objects created
+  /// in this builder afterwards are deduplicated against them too.
+  /// `other` must not be finished, streamed with `StreamTo()`, nor contain any
+  /// 64-bit offsets, and is left unchanged.
+  /// @param[in] other The builder to copy from.
+  /// @return Returns the amount to add to an offset returned by `other` to
+  /// make it refer to the same object in this builder, see `Relocate`.
+  uoffset_t Splice(const FlatBufferBuilderImpl& other) {
+    NotNested();
+    FLATBUFFERS_ASSERT(&other != this);
+    // If you hit these, `other` can't be spliced in its current state.
+    FLATBUFFERS_ASSERT(!other.finished && !other.nested);
+    FLATBUFFERS_ASSERT(!other.num_field_loc);
+    FLATBUFFERS_ASSERT(!other.length_of_64_bit_region_);
+    FLATBUFFERS_ASSERT(!other.buf_.flushed());
+    const SizeT size = other.GetSize();
+    if (!size) return GetSizeRelative32BitRegion();
+    // Everything in `other` is aligned relative to its end, so aligning that
+    // end here keeps it all aligned.
+    Align(other.minalign_);
+    const uoffset_t delta = GetSizeRelative32BitRegion();
+    PushBytes(other.buf_.data(), size);
+
+    if (other.hash_vtables_) {
+      const HashSlot* index = other.VtableIndex();
+      for (uoffset_t i = 0; i < other.vtable_index_size_; i++) {
+        if (index[i].offset) AddSplicedVtable(index[i].offset + delta);
+      }
+    } else if (other.buf_.scratch_size() > other.StringPoolBytes()) {
+      for (auto it = other.VtablesStart(); it < other.buf_.scratch_end();
+           it += sizeof(uoffset_t)) {
+        AddSplicedVtable(*reinterpret_cast<const uoffset_t*>(it) + delta);
+      }
+    }
+    const HashSlot* pool =
+        other.string_pool_size_ ? other.StringPool() : nullptr;
+    for (uoffset_t i = 0; i < other.string_pool_size_; i++) {
+      if (!pool[i].offset) continue;
+      const uoffset_t off = pool[i].offset + delta;
+      if (!StringInMemory(off)) continue;
+      auto str = reinterpret_cast<const String*>(
+          buf_.data_at(off + length_of_64_bit_region_));
+      if (!FindString(str->c_str(), str->size(), pool[i].hash)) {
+        InsertString(off, pool[i].hash);
+      }
+    }
+    return delta;
+  }
+
+  /// @brief Adjust an offset returned by a builder that was spliced into this
+  /// one, so it refers to the same object in this builder.
+  /// @param[in] off An offset returned by the spliced builder.
+  /// @param[in] delta The value returned by `Splice`.
+  template <typename T>
+  static Offset<T> Relocate(Offset<T> off, uoffset_t delta) {
+    return off.IsNull() ? off : Offset<T>(off.o + delta);
+  }
+
   /// @brief Finish serializing a buffer by writing the root offset.
   /// @param[in] file_identifier If a `file_identifier` is given, the buffer
   /// will be prefixed with a standard FlatBuffers file header.
@@ -1296,6 +1626,7 @@ class FlatBufferBuilderImpl {
 
     NotNested();
     buf_.clear_scratch();
+    ClearScratchIndices();
 
     const size_t prefix_size = size_prefix ? sizeof(SizeT) : 0;
     // Make sure we track the alignment of the size prefix.
@@ -1365,21 +1696,35 @@ class FlatBufferBuilderImpl {
 
   bool dedup_vtables_;
 
-  struct StringOffsetCompare {
-    explicit StringOffsetCompare(const vector_downward<SizeT>& buf)
-        : buf_(&buf) {}
-    bool operator()(const Offset<String>& a, const Offset<String>& b) const {
-      auto stra = reinterpret_cast<const String*>(buf_->data_at(a.o));
-      auto strb = reinterpret_cast<const String*>(buf_->data_at(b.o));
-      return StringLessThan(stra->data(), stra->size(), strb->data(),
-                            strb->size());
-    }
-    const vector_downward<SizeT>* buf_;
+  // The scratch area of buf_ starts with the string pool used by
+  // CreateSharedString, followed by the vtables written so far, followed by
+  // whatever is being tracked for the object under construction:
+  //
+  // [string pool][vtables][field locations]
+  //
+  // Both the string pool and (optionally) the vtables are open addressing hash
+  // tables of HashSlot, never more than half full. They only live as long as
+  // the scratch area, and are sized by their number of slots (a power of 2).
+
+  struct HashSlot {
+    uoffset_t offset;  // 0 marks an empty slot.
+    uint32_t hash;
   };
 
-  // For use with CreateSharedString. Instantiated on first use only.
-  typedef std::set<Offset<String>, StringOffsetCompare> StringOffsetMap;
-  StringOffsetMap* string_pool;
+  // When set, the vtable offsets in the scratch area are kept in a hash table
+  // (see InsertVtable) rather than a plain list.
+  bool hash_vtables_;
+  uoffset_t num_vtables_;
+  uoffset_t vtable_index_size_;
+
+  // For use with CreateSharedString. Lazily created on first use only.
+  uoffset_t num_pooled_strings_;
+  uoffset_t string_pool_size_;
+
+  // The precomputed vtable last passed to EndFixedTable, and where it is in
+  // the buffer.
+  const voffset_t* fixed_vtable_;
+  uoffset_t fixed_vtable_offset_;
 
  private:
   void CanAddOffset64() {
@@ -1405,6 +1750,206 @@ class FlatBufferBuilderImpl {
     FLATBUFFERS_ASSERT(GetSize() == length_of_64_bit_region_);
   }
 
+  // Whether all `size` bytes of the object at `offset` (relative to the 32-bit
+  // region) are still in memory. The sink may have been given just the end of
+  // an object, when the buffer ran out of space while it was being written.
+  bool InMemory(uoffset_t offset, size_t size) const {
+    return offset + length_of_64_bit_region_ >= buf_.flushed() + size;
+  }
+
+  bool StringInMemory(uoffset_t offset) const {
+    if (!InMemory(offset, sizeof(uoffset_t))) return false;
+    auto str = reinterpret_cast<const String*>(
+        buf_.data_at(offset + length_of_64_bit_region_));
+    return InMemory(offset, sizeof(uoffset_t) + str->size() + 1);
+  }
+
+  bool VtableInMemory(uoffset_t offset) const {
+    if (!InMemory(offset, sizeof(voffset_t))) return false;
+    return InMemory(offset, ReadScalar<voffset_t>(buf_.data_at(
+                                offset + length_of_64_bit_region_)));
+  }
+
+  // FNV-1a, used to key the hash tables in the scratch area.
+  static uint32_t HashBytes(const void* data, size_t len) {
+    auto bytes = reinterpret_cast<const uint8_t*>(data);
+    uint32_t hash = 0x811C9DC5;
+    for (size_t i = 0; i < len; i++) {
+      hash ^= bytes[i];
+      hash *= 0x01000193;
+    }
+    return hash;
+  }
+
+  static void PlaceSlot(HashSlot* table, uoffset_t table_size,
+                        const HashSlot& slot) {
+    const uoffset_t mask = table_size - 1;
+    uoffset_t i = slot.hash & mask;
+    while (table[i].offset) i = (i + 1) & mask;
+    table[i] = slot;
+  }
+
+  void ClearScratchIndices() {
+    num_vtables_ = 0;
+    vtable_index_size_ = 0;
+    num_pooled_strings_ = 0;
+    string_pool_size_ = 0;
+  }
+
+  size_t StringPoolBytes() const {
+    return string_pool_size_ * sizeof(HashSlot);
+  }
+
+  HashSlot* StringPool() const {
+    return reinterpret_cast<HashSlot*>(buf_.scratch_data());
+  }
+
+  uint8_t* VtablesStart() const {
+    return buf_.scratch_data() + StringPoolBytes();
+  }
+
+  HashSlot* VtableIndex() const {
+    return reinterpret_cast<HashSlot*>(VtablesStart());
+  }
+
+  // Returns the offset of a previously pooled string equal to `str`, or 0 if
+  // there is none.
+  uoffset_t FindString(const char* str, size_t len, uint32_t hash) const {
+    if (!string_pool_size_) return 0;
+    const uoffset_t mask = string_pool_size_ - 1;
+    const HashSlot* pool = StringPool();
+    for (uoffset_t i = hash & mask;; i = (i + 1) & mask) {
+      const HashSlot& slot = pool[i];
+      if (!slot.offset) return 0;
+      if (slot.hash != hash || !StringInMemory(slot.offset)) continue;
+      auto pooled = reinterpret_cast<const String*>(
+          buf_.data_at(slot.offset + length_of_64_bit_region_));
+      if (pooled->size() == len && 0 == memcmp(pooled->data(), str, len)) {
+        return slot.offset;
+      }
+    }
+  }
+
+  void InsertString(uoffset_t offset, uint32_t hash) {
+    if (2 * (num_pooled_strings_ + 1) > string_pool_size_) GrowStringPool();
+    const HashSlot slot = {offset, hash};
+    PlaceSlot(StringPool(), string_pool_size_, slot);
+    num_pooled_strings_++;
+  }
+
+  // The larger pool is built at the end of the scratch area, then moved in
+  // front of the vtables, replacing the current one.
+  void GrowStringPool() {
+    const uoffset_t old_size = string_pool_size_;
+    const uoffset_t new_size = old_size ? old_size * 2 : 16;
+    const size_t old_bytes = old_size * sizeof(HashSlot);
+    const size_t new_bytes = new_size * sizeof(HashSlot);
+    // Only the string pool and vtables may be on the scratch pad at this point.
+    const size_t vtable_bytes = buf_.scratch_size() - old_bytes;
+    buf_.scratch_fill(new_bytes);  // May reallocate.
+    uint8_t* scratch = buf_.scratch_data();
+    auto old_pool = reinterpret_cast<HashSlot*>(scratch);
+    auto new_pool =
+        reinterpret_cast<HashSlot*>(scratch + old_bytes + vtable_bytes);
+    for (uoffset_t i = 0; i < old_size; i++) {
+      if (old_pool[i].offset) PlaceSlot(new_pool, new_size, old_pool[i]);
+    }
+    std::rotate(scratch + old_bytes, scratch + old_bytes + vtable_bytes,
+                buf_.scratch_end());
+    memmove(scratch, scratch + old_bytes, new_bytes + vtable_bytes);
+    buf_.scratch_pop(old_bytes);
+    string_pool_size_ = new_size;
+  }
+
+  // Returns the offset of a previously written vtable identical to `vt`, or 0
+  // if there is none, using whichever way vtables are being tracked.
+  uoffset_t FindExistingVtable(const voffset_t* vt, voffset_t vt_size,
+                               uint32_t hash) const {
+    if (hash_vtables_) return FindVtable(vt, vt_size, hash);
+    for (auto it = VtablesStart(); it < buf_.scratch_end();
+         it += sizeof(uoffset_t)) {
+      auto vt_offset_ptr = reinterpret_cast<const uoffset_t*>(it);
+      if (!VtableInMemory(*vt_offset_ptr)) continue;
+      auto vt2 = reinterpret_cast<const voffset_t*>(
+          buf_.data_at(*vt_offset_ptr + length_of_64_bit_region_));
+      if (ReadScalar<voffset_t>(vt2) == vt_size &&
+          0 == memcmp(vt2, vt, vt_size)) {
+        return *vt_offset_ptr;
+      }
+    }
+    return 0;
+  }
+
+  // Remembers a newly written vtable for future dedup.
+  void RememberVtable(uoffset_t offset, uint32_t hash) {
+    if (hash_vtables_) {
+      InsertVtable(offset, hash);
+    } else {
+      buf_.scratch_push_small(offset);
+    }
+  }
+
+  // Returns the offset of a previously written vtable identical to `vt`, or 0
+  // if there is none.
+  uoffset_t FindVtable(const voffset_t* vt, voffset_t vt_size,
+                       uint32_t hash) const {
+    if (!vtable_index_size_) return 0;
+    const uoffset_t mask = vtable_index_size_ - 1;
+    const HashSlot* index = VtableIndex();
+    for (uoffset_t i = hash & mask;; i = (i + 1) & mask) {
+      const HashSlot& slot = index[i];
+      if (!slot.offset) return 0;
+      if (slot.hash != hash || !VtableInMemory(slot.offset)) continue;
+      auto vt2 = reinterpret_cast<const voffset_t*>(
+          buf_.data_at(slot.offset + length_of_64_bit_region_));
+      if (ReadScalar<voffset_t>(vt2) == vt_size &&
+          0 == memcmp(vt2, vt, vt_size)) {
+        return slot.offset;
+      }
+    }
+  }
+
+  void InsertVtable(uoffset_t offset, uint32_t hash) {
+    if (2 * (num_vtables_ + 1) > vtable_index_size_) GrowVtableIndex();
+    const HashSlot slot = {offset, hash};
+    PlaceSlot(VtableIndex(), vtable_index_size_, slot);
+    num_vtables_++;
+  }
+
+  // Remembers a vtable copied in by Splice for future dedup.
+  void AddSplicedVtable(uoffset_t offset) {
+    if (!hash_vtables_) {
+      buf_.scratch_push_small(offset);
+      return;
+    }
+    if (!VtableInMemory(offset)) return;
+    auto vt = reinterpret_cast<const voffset_t*>(
+        buf_.data_at(offset + length_of_64_bit_region_));
+    const voffset_t vt_size = ReadScalar<voffset_t>(vt);
+    const uint32_t hash = HashBytes(vt, vt_size);
+    if (!FindVtable(vt, vt_size, hash)) InsertVtable(offset, hash);
+  }
+
+  // The index takes the place of the plain list of vtable offsets used by the
+  // linear scan. To grow it, the larger table is built right after the current
+  // one, and then slid down.
+  void GrowVtableIndex() {
+    const uoffset_t old_size = vtable_index_size_;
+    const uoffset_t new_size = old_size ? old_size * 2 : 16;
+    // Only the string pool and vtables may be on the scratch pad at this point.
+    FLATBUFFERS_ASSERT(buf_.scratch_size() ==
+                       StringPoolBytes() + old_size * sizeof(HashSlot));
+    buf_.scratch_fill(new_size * sizeof(HashSlot));  // May reallocate.
+    HashSlot* old_index = VtableIndex();
+    HashSlot* new_index = old_index + old_size;
+    for (uoffset_t i = 0; i < old_size; i++) {
+      if (old_index[i].offset) PlaceSlot(new_index, new_size, old_index[i]);
+    }
+    memmove(old_index, new_index, new_size * sizeof(HashSlot));
+    buf_.scratch_pop(old_size * sizeof(HashSlot));
+    vtable_index_size_ = new_size;
+  }
+
   /// @brief Store a string in the buffer, which can contain any binary data.
   /// @param[in] str A const char pointer to the data to be stored as a string.
   /// @param[in] len The number of bytes that should be stored from `str`.
@@ -0,0 +1,238 @@
+/*
+ * Copyright 2024 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLATBUFFERS_FLATBUFFER_BUILDER_POOL_H_
+#define FLATBUFFERS_FLATBUFFER_BUILDER_POOL_H_
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "flatbuffers/allocator.h"
+#include "flatbuffers/base.h"
+#include "flatbuffers/flatbuffer_builder.h"
+
+namespace flatbuffers {
+
+// Allocator that keeps freed memory blocks around for reuse, rather than
+// returning them to the heap. Blocks are handed out in power of 2 size
+// classes, so a block freed by one buffer can serve a later one of similar
+// size. Safe to use from multiple threads at once.
+class RecyclingAllocator : public Allocator {
+ public:
+  // Blocks larger than `high_water_mark` are freed instead of kept, as are
+  // blocks freed while `max_cached_blocks` are already being kept.
+  explicit RecyclingAllocator(size_t high_water_mark,
+                              size_t max_cached_blocks)
+      : high_water_mark_(high_water_mark),
+        max_cached_blocks_(max_cached_blocks),
+        num_cached_blocks_(0) {
+    for (size_t i = 0; i < kNumSizeClasses; i++) free_blocks_[i] = nullptr;
+  }
+
+  ~RecyclingAllocator() FLATBUFFERS_OVERRIDE { Trim(); }
+
+  uint8_t* allocate(size_t size) FLATBUFFERS_OVERRIDE {
+    const size_t size_class = SizeClass(size);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      FreeBlock* block = free_blocks_[size_class];
+      if (block) {
+        free_blocks_[size_class] = block->next;
+        num_cached_blocks_--;
+        return reinterpret_cast<uint8_t*>(block);
+      }
+    }
+    return DefaultAllocator().allocate(size_t(1) << size_class);
+  }
+
+  void deallocate(uint8_t* p, size_t size) FLATBUFFERS_OVERRIDE {
+    const size_t size_class = SizeClass(size);
+    if ((size_t(1) << size_class) <= high_water_mark_) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (num_cached_blocks_ < max_cached_blocks_) {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(p);
+        block->next = free_blocks_[size_class];
+        free_blocks_[size_class] = block;
+        num_cached_blocks_++;
+        return;
+      }
+    }
+    DefaultAllocator().deallocate(p, size_t(1) << size_class);
+  }
+
+  // Returns all cached blocks to the heap.
+  void Trim() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < kNumSizeClasses; i++) {
+      while (free_blocks_[i]) {
+        FreeBlock* block = free_blocks_[i];
+        free_blocks_[i] = block->next;
+        DefaultAllocator().deallocate(reinterpret_cast<uint8_t*>(block),
+                                      size_t(1) << i);
+      }
+    }
+    num_cached_blocks_ = 0;
+  }
+
+  size_t high_water_mark() const { return high_water_mark_; }
+
+ private:
+  // Freed blocks are linked through their own memory.
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  static const size_t kMinSizeClass = 6;  // 64 bytes.
+  static const size_t kNumSizeClasses = sizeof(size_t) * 8;
+
+  static size_t SizeClass(size_t size) {
+    size_t size_class = kMinSizeClass;
+    while ((size_t(1) << size_class) < size) size_class++;
+    return size_class;
+  }
+
+  FLATBUFFERS_DELETE_FUNC(RecyclingAllocator(const RecyclingAllocator&));
+  FLATBUFFERS_DELETE_FUNC(
+      RecyclingAllocator& operator=(const RecyclingAllocator&));
+
+  const size_t high_water_mark_;
+  const size_t max_cached_blocks_;
+  std::mutex mutex_;
+  FreeBlock* free_blocks_[kNumSizeClasses];
+  size_t num_cached_blocks_;
+};
+
+/// @addtogroup flatbuffers_cpp_api
+/// @{
+/// @class FlatBufferBuilderPool
+/// @brief Lends out FlatBufferBuilders that keep their buffers allocated
+/// between uses, so that steady-state serialization does not hit the heap.
+/// Buffers detached from a pooled builder (with `Release()`) are returned to
+/// the pool when the `DetachedBuffer` is destroyed, so the pool must outlive
+/// them. Safe to use from multiple threads at once.
+template <bool Is64Aware = false>
+class FlatBufferBuilderPoolImpl {
+ public:
+  typedef FlatBufferBuilderImpl<Is64Aware> Builder;
+
+  struct Options {
+    // The initial size of the buffer of each builder.
+    size_t initial_size = 1024;
+    // Builders whose buffer grew larger than this drop it when returned to
+    // the pool, and freed buffers larger than this are not kept.
+    size_t high_water_mark = 1024 * 1024;
+    // The maximum number of idle builders kept in the pool.
+    size_t max_idle_builders = 64;
+    // The maximum number of freed buffers kept in the pool.
+    size_t max_cached_buffers = 64;
+  };
+
+  /// @brief A builder lent out by the pool, which goes back to the pool when
+  /// this is destroyed.
+  class Lease {
+   public:
+    Lease(Lease&& other) noexcept
+        : pool_(other.pool_), builder_(std::move(other.builder_)) {}
+
+    ~Lease() {
+      if (builder_) pool_->Return(std::move(builder_));
+    }
+
+    Builder& operator*() const { return *builder_; }
+    Builder* operator->() const { return builder_.get(); }
+    Builder* get() const { return builder_.get(); }
+
+   private:
+    friend class FlatBufferBuilderPoolImpl;
+
+    Lease(FlatBufferBuilderPoolImpl* pool, std::unique_ptr<Builder> builder)
+        : pool_(pool), builder_(std::move(builder)) {}
+
+    FLATBUFFERS_DELETE_FUNC(Lease(const Lease&));
+    FLATBUFFERS_DELETE_FUNC(Lease& operator=(const Lease&));
+
+    FlatBufferBuilderPoolImpl* pool_;
+    std::unique_ptr<Builder> builder_;
+  };
+
+  explicit FlatBufferBuilderPoolImpl(const Options& opts = Options())
+      : opts_(opts),
+        allocator_(opts.high_water_mark, opts.max_cached_buffers) {}
+
+  /// @brief Get a cleared builder, reusing an idle one if possible.
+  Lease Acquire() {
+    std::unique_ptr<Builder> builder;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!idle_builders_.empty()) {
+        builder = std::move(idle_builders_.back());
+        idle_builders_.pop_back();
+      }
+    }
+    if (!builder) {
+      builder.reset(new Builder(opts_.initial_size, &allocator_, false));
+    }
+    return Lease(this, std::move(builder));
+  }
+
+  /// @brief Frees the memory of all idle builders and cached buffers.
+  void Trim() {
+    std::vector<std::unique_ptr<Builder>> idle_builders;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      idle_builders.swap(idle_builders_);
+    }
+    idle_builders.clear();
+    allocator_.Trim();
+  }
+
+  /// @brief The allocator used by all builders of this pool. Buffers
+  /// allocated through it are recycled by the pool as well.
+  Allocator* GetAllocator() { return &allocator_; }
+
+ private:
+  FLATBUFFERS_DELETE_FUNC(
+      FlatBufferBuilderPoolImpl(const FlatBufferBuilderPoolImpl&));
+  FLATBUFFERS_DELETE_FUNC(
+      FlatBufferBuilderPoolImpl& operator=(const FlatBufferBuilderPoolImpl&));
+
+  void Return(std::unique_ptr<Builder> builder) {
+    if (builder->GetCapacity() > opts_.high_water_mark) {
+      builder->Reset();
+    } else {
+      builder->Clear();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (idle_builders_.size() < opts_.max_idle_builders) {
+      idle_builders_.push_back(std::move(builder));
+    }
+  }
+
+  const Options opts_;
+  // Declared before the builders, which use it until they are destroyed.
+  RecyclingAllocator allocator_;
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<Builder>> idle_builders_;
+};
+/// @}
+
+using FlatBufferBuilderPool = FlatBufferBuilderPoolImpl<false>;
+using FlatBufferBuilderPool64 = FlatBufferBuilderPoolImpl<true>;
+
+}  // namespace flatbuffers
+
+#endif  // FLATBUFFERS_FLATBUFFER_BUILDER_POOL_H_
@@ -17,9 +17,16 @@
 #ifndef FLATBUFFERS_FLEX_FLAT_UTIL_H_
 #define FLATBUFFERS_FLEX_FLAT_UTIL_H_
 
+#include <string>
+
 #include "flatbuffers/flatbuffers.h"
 #include "flatbuffers/flexbuffers.h"
 
+namespace reflection {
+struct Object;
+struct Schema;
+}  // namespace reflection
+
 namespace flexbuffers {
 
 // Verifies the `nested` flexbuffer within a flatbuffer vector is valid.
@@ -32,6 +39,30 @@ inline bool VerifyNestedFlexBuffer(
       nested->data(), nested->size(), verifier.GetFlexReuseTracker()));
 }
 
+
+// Writes the FlexBuffer map `map` to `fbb` as a table of type `object` from
+// `schema`, without going through JSON. Keys are field names, and values are
+// converted the way the JSON parser would: enum values may be given by name,
+// tables and structs as maps, and unions as a map with the union type in the
+// `<field>_type` key. Integers must fit their field, and vectors of tables or
+// structs with a key are sorted (and put in Eytzinger order if the field has
+// the `eytzinger` attribute).
+// Returns the offset of the table, or 0 if `map` does not fit `object`, in
+// which case `error` (if not null) says why, and `fbb` must be cleared before
+// it is used again.
+// Implemented in reflection.cpp.
+flatbuffers::uoffset_t FlexToFlatTable(const reflection::Schema& schema,
+                                       const reflection::Object& object,
+                                       Reference map,
+                                       flatbuffers::FlatBufferBuilder& fbb,
+                                       std::string* error = nullptr);
+
+// Like FlexToFlatTable(), but for the root table of `schema`, and finishes
+// `fbb` with the file identifier of `schema`.
+bool FlexToFlatBuffer(const reflection::Schema& schema, Reference root,
+                      flatbuffers::FlatBufferBuilder& fbb,
+                      std::string* error = nullptr);
+
 }  // namespace flexbuffers
 
 #endif  // FLATBUFFERS_FLEX_FLAT_UTIL_H_
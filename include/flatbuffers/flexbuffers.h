@@ -19,8 +19,11 @@
 
 #include <algorithm>
 #include <map>
+#include <unordered_map>
 // Used to select STL variant.
 #include "flatbuffers/base.h"
+#include "flatbuffers/buffer_sink.h"
+#include "flatbuffers/parallel_for.h"
 // We use the basic binary writing functions from the regular FlatBuffers.
 #include "flatbuffers/util.h"
 
@@ -37,6 +40,7 @@ namespace flexbuffers {
 
 class Reference;
 class Map;
+class EditableFlexBuffer;
 
 // These are used in the lower 2 bits of a type field to determine the size of
 // the elements (and or size field) of the item pointed to (e.g. vector).
@@ -187,6 +191,71 @@ inline const uint8_t* Indirect(const uint8_t* offset, uint8_t byte_width) {
   return offset - ReadUInt64(offset, byte_width);
 }
 
+// Converts `len` scalars of type `S` at `data` to `T`. A plain loop with the
+// source type known up front, which compilers turn into vector code.
+// Floats become integers through int64_t, like AsInt32() etc. do, as a float
+// outside the range of a narrower integer type can't be converted to it.
+template <typename S, typename T>
+void CopyScalars(const uint8_t* data, size_t len, T* dest) {
+  if (FLATBUFFERS_LITTLEENDIAN && std::is_same<S, T>::value) {
+    memcpy(dest, data, len * sizeof(T));
+    return;
+  }
+  typedef typename flatbuffers::conditional<
+      flatbuffers::is_floating_point<S>::value &&
+          !flatbuffers::is_floating_point<T>::value,
+      int64_t, T>::type Via;
+  auto src = reinterpret_cast<const S*>(data);
+  for (size_t i = 0; i < len; i++) {
+    dest[i] =
+        static_cast<T>(static_cast<Via>(flatbuffers::EndianScalar(src[i])));
+  }
+}
+
+// Picks the loop for `byte_width` once for the whole run, like
+// ReadSizedScalar() does for a single element.
+template <typename T, typename S1, typename S2, typename S4, typename S8>
+void CopySizedScalars(const uint8_t* data, uint8_t byte_width, size_t len,
+                      T* dest) {
+  if (byte_width < 4) {
+    if (byte_width < 2) {
+      CopyScalars<S1>(data, len, dest);
+    } else {
+      CopyScalars<S2>(data, len, dest);
+    }
+  } else {
+    if (byte_width < 8) {
+      CopyScalars<S4>(data, len, dest);
+    } else {
+      CopyScalars<S8>(data, len, dest);
+    }
+  }
+}
+
+// Converts `len` elements of a typed vector of `type` to `T`. Returns false
+// for elements that aren't numbers.
+template <typename T>
+bool CopyTypedScalars(const uint8_t* data, uint8_t byte_width, Type type,
+                      size_t len, T* dest) {
+  switch (type) {
+    case FBT_INT:
+      CopySizedScalars<T, int8_t, int16_t, int32_t, int64_t>(data, byte_width,
+                                                             len, dest);
+      return true;
+    case FBT_UINT:
+    case FBT_BOOL:
+      CopySizedScalars<T, uint8_t, uint16_t, uint32_t, uint64_t>(
+          data, byte_width, len, dest);
+      return true;
+    case FBT_FLOAT:
+      CopySizedScalars<T, quarter, half, float, double>(data, byte_width, len,
+                                                        dest);
+      return true;
+    default:
+      return false;
+  }
+}
+
 template <typename T>
 const uint8_t* Indirect(const uint8_t* offset) {
   return offset - flatbuffers::ReadScalar<T>(offset);
@@ -222,6 +291,8 @@ class Object {
       : data_(data), byte_width_(byte_width) {}
 
  protected:
+  friend EditableFlexBuffer;
+
   const uint8_t* data_;
   uint8_t byte_width_;
 };
@@ -307,6 +378,16 @@ class TypedVector : public Sized {
 
   Type ElementType() { return type_; }
 
+  // Copies up to `len` elements to `dest`, converted like AsInt64(),
+  // AsDouble() etc. would, but much faster than element by element.
+  // Returns the number of elements copied, which is 0 if the elements aren't
+  // numbers.
+  template <typename T>
+  size_t CopyTo(T* dest, size_t len) const {
+    len = (std::min)(len, size());
+    return CopyTypedScalars(data_, byte_width_, type_, len, dest) ? len : 0;
+  }
+
   friend Reference;
 
  private:
@@ -334,17 +415,70 @@ class FixedTypedVector : public Object {
   Type ElementType() const { return type_; }
   uint8_t size() const { return len_; }
 
+  // See TypedVector::CopyTo().
+  template <typename T>
+  size_t CopyTo(T* dest, size_t len) const {
+    len = (std::min)(len, static_cast<size_t>(len_));
+    return CopyTypedScalars(data_, byte_width_, type_, len, dest) ? len : 0;
+  }
+
  private:
   Type type_;
   uint8_t len_;
 };
 
+// A key prepared for looking up many times, see
+// Map::operator[](const MapKey&). It remembers where it was found in the key
+// vectors it was last looked up in, so finding it again in a map with one of
+// those key vectors (e.g. maps written with BUILDER_FLAG_SHARE_KEY_VECTORS)
+// takes a single comparison instead of a binary search.
+// The string must outlive the MapKey. A MapKey must not be used from multiple
+// threads at once.
+class MapKey {
+ public:
+  explicit MapKey(const char* key) : MapKey(key, strlen(key)) {}
+  MapKey(const char* key, size_t len) : key_(key), len_(len) {
+    for (size_t i = 0; i < kCacheSize; i++) cache_[i] = CacheEntry();
+  }
+
+  const char* data() const { return key_; }
+  size_t length() const { return len_; }
+
+ private:
+  friend Map;
+
+  struct CacheEntry {
+    CacheEntry() : keys(nullptr), index(0) {}
+    const uint8_t* keys;
+    size_t index;
+  };
+
+  static const size_t kCacheSize = 4;
+
+  // Compares with a key in a buffer, like strcmp.
+  int Compare(const char* key) const {
+    auto comp = strncmp(key_, key, len_);
+    if (comp) return comp;
+    return key[len_] ? -1 : 0;
+  }
+
+  CacheEntry& CacheEntryFor(const uint8_t* keys) const {
+    // Key vectors are at least 2 bytes apart (their size and one key).
+    return cache_[(reinterpret_cast<uintptr_t>(keys) >> 1) % kCacheSize];
+  }
+
+  const char* key_;
+  size_t len_;
+  mutable CacheEntry cache_[kCacheSize];
+};
+
 class Map : public Vector {
  public:
   Map(const uint8_t* data, uint8_t byte_width) : Vector(data, byte_width) {}
 
   Reference operator[](const char* key) const;
   Reference operator[](const std::string& key) const;
+  Reference operator[](const MapKey& key) const;
 
   Vector Values() const { return Vector(data_, byte_width_); }
 
@@ -844,6 +978,7 @@ class Reference {
   }
 
   friend class Verifier;
+  friend EditableFlexBuffer;
 
   const uint8_t* data_;
   uint8_t parent_width_;
@@ -1004,6 +1139,36 @@ inline Reference Map::operator[](const std::string& key) const {
   return (*this)[key.c_str()];
 }
 
+inline Reference Map::operator[](const MapKey& key) const {
+  auto keys = Keys();
+  auto key_at = [&](size_t i) {
+    return reinterpret_cast<const char*>(
+        Indirect(keys.data_ + i * keys.byte_width_, keys.byte_width_));
+  };
+  auto& entry = key.CacheEntryFor(keys.data_);
+  if (entry.keys == keys.data_ && entry.index < keys.size() &&
+      !key.Compare(key_at(entry.index))) {
+    return (*static_cast<const Vector*>(this))[entry.index];
+  }
+  size_t lo = 0;
+  size_t hi = keys.size();
+  while (lo < hi) {
+    auto mid = lo + (hi - lo) / 2;
+    auto comp = key.Compare(key_at(mid));
+    if (!comp) {
+      entry.keys = keys.data_;
+      entry.index = mid;
+      return (*static_cast<const Vector*>(this))[mid];
+    }
+    if (comp < 0) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  return Reference(nullptr, 1, NullPackedType());
+}
+
 inline Reference GetRoot(const uint8_t* buffer, size_t size) {
   // See Finish() below for the serialization counterpart of this.
   // The root starts at the end of the buffer, so we parse backwards from there.
@@ -1075,6 +1240,7 @@ class Builder FLATBUFFERS_FINAL_CLASS {
     force_min_bit_width_ = BIT_WIDTH_8;
     key_pool.clear();
     string_pool.clear();
+    key_vector_pool.clear();
   }
 
   // All value constructing functions below have two versions: one that
@@ -1262,36 +1428,41 @@ class Builder FLATBUFFERS_FINAL_CLASS {
       Value val;
     };
     // TODO(wvo): strict aliasing?
-    // TODO(wvo): allow the caller to indicate the data is already sorted
-    // for maximum efficiency? With an assert to check sortedness to make sure
-    // we're not breaking binary search.
-    // Or, we can track if the map is sorted as keys are added which would be
-    // be quite cheap (cheaper than checking it here), so we can skip this
-    // step automatically when appliccable, and encourage people to write in
-    // sorted fashion.
-    // std::sort is typically already a lot faster on sorted data though.
     auto dict = reinterpret_cast<TwoValue*>(stack_.data() + start);
-    std::sort(dict, dict + len,
-              [&](const TwoValue& a, const TwoValue& b) -> bool {
-                auto as = reinterpret_cast<const char*>(buf_.data() + a.key.u_);
-                auto bs = reinterpret_cast<const char*>(buf_.data() + b.key.u_);
-                auto comp = strcmp(as, bs);
-                // We want to disallow duplicate keys, since this results in a
-                // map where values cannot be found.
-                // But we can't assert here (since we don't want to fail on
-                // random JSON input) or have an error mechanism.
-                // Instead, we set has_duplicate_keys_ in the builder to
-                // signal this.
-                // TODO: Have to check for pointer equality, as some sort
-                // implementation apparently call this function with the same
-                // element?? Why?
-                if (!comp && &a != &b) has_duplicate_keys_ = true;
-                return comp < 0;
-              });
-    // First create a vector out of all keys.
-    // TODO(wvo): if kBuilderFlagShareKeyVectors is true, see if we can share
-    // the first vector.
-    auto keys = CreateVector(start, len, 2, true, false);
+    // Maps are often written with their keys in order already, in which case
+    // a single pass over neighbouring keys is all we need.
+    bool sorted = true;
+    for (size_t i = 1; i < len; i++) {
+      auto comp = KeyCompare(dict[i - 1].key, dict[i].key);
+      if (comp > 0) {
+        sorted = false;
+        break;
+      }
+      // See below.
+      if (!comp) has_duplicate_keys_ = true;
+    }
+    if (!sorted) {
+      std::sort(dict, dict + len,
+                [&](const TwoValue& a, const TwoValue& b) -> bool {
+                  auto comp = KeyCompare(a.key, b.key);
+                  // We want to disallow duplicate keys, since this results in
+                  // a map where values cannot be found.
+                  // But we can't assert here (since we don't want to fail on
+                  // random JSON input) or have an error mechanism.
+                  // Instead, we set has_duplicate_keys_ in the builder to
+                  // signal this.
+                  // TODO: Have to check for pointer equality, as some sort
+                  // implementation apparently call this function with the
+                  // same element?? Why?
+                  if (!comp && &a != &b) has_duplicate_keys_ = true;
+                  return comp < 0;
+                });
+    }
+    // First create a vector out of all keys, or reuse an earlier one holding
+    // the same keys.
+    auto keys = (flags_ & BUILDER_FLAG_SHARE_KEY_VECTORS)
+                    ? SharedKeyVector(start, len)
+                    : CreateVector(start, len, 2, true, false);
     auto vec = CreateVector(start + 1, len, 2, false, false, &keys);
     // Remove temp elements and return map.
     stack_.resize(start);
@@ -1780,6 +1951,48 @@ class Builder FLATBUFFERS_FINAL_CLASS {
                  bit_width);
   }
 
+  int KeyCompare(const Value& a, const Value& b) const {
+    if (a.u_ == b.u_) return 0;
+    auto as = reinterpret_cast<const char*>(buf_.data() + a.u_);
+    auto bs = reinterpret_cast<const char*>(buf_.data() + b.u_);
+    return strcmp(as, bs);
+  }
+
+  // Returns a vector holding the sorted keys at every other stack element
+  // from `start`, reusing one created by an earlier map if possible.
+  // Maps find each other by the offsets of their keys, so this works best
+  // together with BUILDER_FLAG_SHARE_KEYS.
+  Value SharedKeyVector(size_t start, size_t len) {
+    // FNV-1a over the key offsets.
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len; i++) {
+      hash ^= stack_[start + i * 2].u_;
+      hash *= 0x100000001b3ULL;
+    }
+    auto range = key_vector_pool.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (HasKeys(it->second, start, len)) return it->second;
+    }
+    auto keys = CreateVector(start, len, 2, true, false);
+    key_vector_pool.insert(std::make_pair(hash, keys));
+    return keys;
+  }
+
+  // Whether the key vector `keys` in buf_ refers to the same keys as the
+  // stack elements checked by SharedKeyVector().
+  bool HasKeys(const Value& keys, size_t start, size_t len) const {
+    auto byte_width = static_cast<uint8_t>(1U << keys.min_bit_width_);
+    auto data = buf_.data() + keys.u_;
+    if (ReadUInt64(data - byte_width, byte_width) != len) return false;
+    for (size_t i = 0; i < len; i++) {
+      auto elem = data + i * byte_width;
+      auto key = static_cast<uint64_t>(elem - buf_.data()) -
+                 ReadUInt64(elem, byte_width);
+      if (key != stack_[start + i * 2].u_) return false;
+    }
+    return true;
+  }
+
   // You shouldn't really be copying instances of this class.
   Builder(const Builder&);
   Builder& operator=(const Builder&);
@@ -1822,10 +2035,640 @@ class Builder FLATBUFFERS_FINAL_CLASS {
 
   KeyOffsetMap key_pool;
   StringOffsetMap string_pool;
+  // Key vectors of earlier maps, by a hash of the offsets of their keys.
+  std::unordered_multimap<uint64_t, Value> key_vector_pool;
 
   friend class Verifier;
 };
 
+// Writes a FlexBuffer whose root is one large typed vector or map of scalars
+// to a BufferSink, as its elements are added. Unlike Builder, it does not
+// keep the elements in memory, so it can write any number of them in a
+// buffer of `buffer_size` bytes.
+// In exchange, the number of elements and the width they are stored with
+// must be given up front. If the width is not known, find it with a first
+// pass over the data using WidthI(), WidthU() or WidthF().
+class StreamingBuilder FLATBUFFERS_FINAL_CLASS {
+ public:
+  explicit StreamingBuilder(flatbuffers::BufferSink* sink,
+                            size_t buffer_size = 4096)
+      : sink_(sink),
+        buffer_size_(buffer_size),
+        size_(0),
+        failed_(false),
+        state_(kNone),
+        type_(FBT_NULL),
+        bit_width_(BIT_WIDTH_8),
+        count_(0),
+        remaining_(0),
+        vloc_(0),
+        keys_loc_(0),
+        key_stride_(0) {
+    buf_.reserve(buffer_size);
+  }
+
+  // Starts a root vector of `count` elements of `type` (FBT_INT, FBT_UINT,
+  // FBT_FLOAT or FBT_BOOL), each stored in at least `bit_width` bits.
+  // Add the elements with the functions below.
+  void StartVector(Type type, BitWidth bit_width, size_t count) {
+    FLATBUFFERS_ASSERT(state_ == kNone);
+    FLATBUFFERS_ASSERT(type == FBT_INT || type == FBT_UINT ||
+                       type == FBT_FLOAT || type == FBT_BOOL);
+    StartValues(type, bit_width, count);
+    state_ = kVectorValues;
+  }
+
+  // Starts a root map of `count` values of `type`, like StartVector().
+  // First add all keys with Key(), in strcmp() order, then all values in the
+  // same order. Keys may be at most `max_key_len` bytes, and each takes up
+  // `max_key_len + 1` bytes in the buffer.
+  void StartMap(Type type, BitWidth bit_width, size_t count,
+                size_t max_key_len) {
+    FLATBUFFERS_ASSERT(state_ == kNone);
+    FLATBUFFERS_ASSERT(type == FBT_INT || type == FBT_UINT ||
+                       type == FBT_FLOAT || type == FBT_BOOL);
+    type_ = type;
+    bit_width_ = bit_width;
+    count_ = count;
+    remaining_ = count;
+    keys_loc_ = size_;
+    key_stride_ = max_key_len + 1;
+    state_ = kMapKeys;
+    if (!count) EndKeys();
+  }
+
+  void Key(const char* key) {
+    FLATBUFFERS_ASSERT(state_ == kMapKeys && remaining_);
+    auto len = strlen(key);
+    FLATBUFFERS_ASSERT(len < key_stride_);
+    // Keys must be sorted, since we can't sort them for you.
+    FLATBUFFERS_ASSERT(remaining_ == count_ || last_key_.compare(key) < 0);
+    last_key_.assign(key, len);
+    WriteBytes(key, len);
+    WritePadding(key_stride_ - len);
+    if (!--remaining_) EndKeys();
+  }
+
+  void Int(int64_t i) {
+    FLATBUFFERS_ASSERT(type_ == FBT_INT && WidthI(i) <= bit_width_);
+    AddValue(static_cast<uint64_t>(i));
+  }
+
+  void UInt(uint64_t u) {
+    FLATBUFFERS_ASSERT(type_ == FBT_UINT && WidthU(u) <= bit_width_);
+    AddValue(u);
+  }
+
+  void Bool(bool b) {
+    FLATBUFFERS_ASSERT(type_ == FBT_BOOL);
+    AddValue(static_cast<uint64_t>(b));
+  }
+
+  void Double(double f) {
+    FLATBUFFERS_ASSERT(type_ == FBT_FLOAT && bit_width_ >= BIT_WIDTH_32);
+    uint64_t bits;
+    if (bit_width_ == BIT_WIDTH_32) {
+      auto f32 = static_cast<float>(f);
+      uint32_t bits32;
+      memcpy(&bits32, &f32, sizeof(bits32));
+      bits = bits32;
+    } else {
+      memcpy(&bits, &f, sizeof(bits));
+    }
+    AddValue(bits);
+  }
+
+  void Float(float f) { Double(f); }
+
+  // Writes the end of the buffer, once all elements have been added, and
+  // hands what is left to the sink. Returns false if the sink failed.
+  bool Finish() {
+    FLATBUFFERS_ASSERT(!remaining_ && (state_ == kVectorValues ||
+                                       state_ == kMapValues));
+    auto root_type = ToTypedVector(type_);
+    if (state_ == kMapValues) {
+      // Map values have a type byte each.
+      auto packed_type = PackedType(bit_width_, type_);
+      for (size_t i = 0; i < count_; i++) WriteBytes(&packed_type, 1);
+      root_type = FBT_MAP;
+    }
+    // Write root value, type and size, like Builder::Finish().
+    auto root_width = OffsetWidth(vloc_, BIT_WIDTH_8);
+    auto byte_width = Align(root_width);
+    WriteUInt(size_ - vloc_, byte_width);
+    auto packed_type = PackedType(bit_width_, root_type);
+    WriteBytes(&packed_type, 1);
+    WriteBytes(&byte_width, 1);
+    Flush();
+    state_ = kFinished;
+    return !failed_;
+  }
+
+  // Size of the buffer so far, including what was handed to the sink.
+  size_t GetSize() const { return size_; }
+
+ private:
+  enum State { kNone, kVectorValues, kMapKeys, kMapValues, kFinished };
+
+  void StartValues(Type type, BitWidth bit_width, size_t count) {
+    type_ = type;
+    // The size field is as wide as the elements.
+    bit_width_ = (std::max)(bit_width, WidthU(count));
+    count_ = count;
+    remaining_ = count;
+    auto byte_width = Align(bit_width_);
+    WriteUInt(count, byte_width);
+    vloc_ = size_;
+  }
+
+  // Writes the vector of keys, and the start of the map.
+  void EndKeys() {
+    // Key i is at keys_loc_ + i * key_stride_, so the offsets to them are
+    // largest for either the first or the last key.
+    auto keys_width = WidthU(count_);
+    for (;; keys_width = static_cast<BitWidth>(keys_width + 1)) {
+      auto byte_width = size_t(1) << keys_width;
+      auto kvloc = size_ + flatbuffers::PaddingBytes(size_, byte_width) +
+                   byte_width;
+      auto first = kvloc - keys_loc_;
+      auto last = count_ ? kvloc + (count_ - 1) * byte_width -
+                               (keys_loc_ + (count_ - 1) * key_stride_)
+                         : 0;
+      if (keys_width == BIT_WIDTH_64 ||
+          ((size_t(1) << WidthU((std::max)(first, last))) <= byte_width)) {
+        break;
+      }
+    }
+    auto keys_byte_width = Align(keys_width);
+    WriteUInt(count_, keys_byte_width);
+    auto kvloc = size_;
+    for (size_t i = 0; i < count_; i++) {
+      WriteUInt(size_ - (keys_loc_ + i * key_stride_), keys_byte_width);
+    }
+    // The map starts with the offset and width of the keys, followed by the
+    // size, all as wide as the values.
+    auto bit_width = (std::max)(bit_width_, WidthU(count_));
+    bit_width_ = OffsetWidth(kvloc, bit_width);
+    auto byte_width = Align(bit_width_);
+    WriteUInt(size_ - kvloc, byte_width);
+    WriteUInt(keys_byte_width, byte_width);
+    WriteUInt(count_, byte_width);
+    vloc_ = size_;
+    remaining_ = count_;
+    state_ = kMapValues;
+  }
+
+  void AddValue(uint64_t bits) {
+    FLATBUFFERS_ASSERT((state_ == kVectorValues || state_ == kMapValues) &&
+                       remaining_);
+    remaining_--;
+    WriteUInt(bits, static_cast<uint8_t>(1U << bit_width_));
+  }
+
+  // The smallest width of at least `min_width` in which an offset to
+  // `target`, stored at the (aligned) end of the buffer, fits (see
+  // Builder::Value::ElemWidth()).
+  BitWidth OffsetWidth(size_t target, BitWidth min_width) const {
+    for (auto bit_width = min_width;;
+         bit_width = static_cast<BitWidth>(bit_width + 1)) {
+      auto byte_width = size_t(1) << bit_width;
+      auto offset_loc = size_ + flatbuffers::PaddingBytes(size_, byte_width);
+      if (bit_width == BIT_WIDTH_64 ||
+          (size_t(1) << WidthU(offset_loc - target)) <= byte_width) {
+        return bit_width;
+      }
+    }
+  }
+
+  uint8_t Align(BitWidth alignment) {
+    auto byte_width = 1U << alignment;
+    WritePadding(flatbuffers::PaddingBytes(size_, byte_width));
+    return static_cast<uint8_t>(byte_width);
+  }
+
+  void WriteUInt(uint64_t u, size_t byte_width) {
+    uint8_t bytes[sizeof(uint64_t)];
+    flatbuffers::WriteScalar(bytes, u);
+    // Little endian, so the low bytes come first.
+    WriteBytes(bytes, byte_width);
+  }
+
+  void WritePadding(size_t len) {
+    static const uint8_t zeros[16] = {};
+    while (len) {
+      auto n = (std::min)(len, sizeof(zeros));
+      WriteBytes(zeros, n);
+      len -= n;
+    }
+  }
+
+  void WriteBytes(const void* data, size_t len) {
+    auto bytes = reinterpret_cast<const uint8_t*>(data);
+    size_ += len;
+    while (len) {
+      if (buf_.size() == buffer_size_) Flush();
+      auto n = (std::min)(len, buffer_size_ - buf_.size());
+      buf_.insert(buf_.end(), bytes, bytes + n);
+      bytes += n;
+      len -= n;
+    }
+  }
+
+  void Flush() {
+    if (!buf_.empty() && !failed_) {
+      failed_ = !sink_->Write(buf_.data(), buf_.size());
+    }
+    buf_.clear();
+  }
+
+  // You shouldn't really be copying instances of this class.
+  StreamingBuilder(const StreamingBuilder&);
+  StreamingBuilder& operator=(const StreamingBuilder&);
+
+  flatbuffers::BufferSink* sink_;
+  std::vector<uint8_t> buf_;
+  size_t buffer_size_;
+  // Bytes written so far, including those handed to the sink.
+  size_t size_;
+  bool failed_;
+  State state_;
+  Type type_;
+  BitWidth bit_width_;
+  size_t count_;
+  size_t remaining_;
+  size_t vloc_;
+  size_t keys_loc_;
+  size_t key_stride_;
+  std::string last_key_;
+};
+
+// A copy of a FlexBuffer that can be edited, for documents that are updated
+// a little at a time. Where the Reference::Mutate functions give up because
+// a new value does not fit the space of the old one, this writes the value
+// to a slack region in front of the document, and points the vector or map
+// element at it. The space of the old value is left as garbage, until
+// Compact() rebuilds the document.
+// Editing invalidates References to the value being replaced (but no
+// others); Compact() invalidates all of them.
+class EditableFlexBuffer FLATBUFFERS_FINAL_CLASS {
+ public:
+  EditableFlexBuffer(const uint8_t* buf, size_t size,
+                     size_t slack_size = 4096) {
+    Reset(buf, size, slack_size);
+  }
+
+  Reference GetRoot() const { return flexbuffers::GetRoot(data(), size()); }
+
+  // The edited FlexBuffer, which includes the part of the slack region in
+  // use.
+  const uint8_t* data() const { return buf_.data() + start(); }
+  size_t size() const { return buf_.size() - start(); }
+
+  // Bytes of the slack region not in use yet.
+  size_t slack() const { return slack_top_; }
+
+  // Set element `i` of `vec` (or the value of `key` in `map`), which must
+  // be a (non-typed) vector or map of this buffer, to a new value of any
+  // type. Returns false if `i` or `key` doesn't exist, or if there is no
+  // room for the value: the slack region is full, or it is too far away to
+  // be referred to by the element. In that case, Compact() and try again.
+  // Scalars are changed in place when they fit. Strings of the document may
+  // be shared with other elements, so a new string is always written to the
+  // slack region, unless it replaces one written there before.
+  bool SetInt(const Vector& vec, size_t i, int64_t v) {
+    return SetScalar(Slot(vec, i), FBT_INT, static_cast<uint64_t>(v),
+                     WidthI(v));
+  }
+  bool SetUInt(const Vector& vec, size_t i, uint64_t v) {
+    return SetScalar(Slot(vec, i), FBT_UINT, v, WidthU(v));
+  }
+  bool SetBool(const Vector& vec, size_t i, bool v) {
+    return SetScalar(Slot(vec, i), FBT_BOOL, v, BIT_WIDTH_8);
+  }
+  bool SetDouble(const Vector& vec, size_t i, double v) {
+    auto width = WidthF(v);
+    uint64_t bits;
+    if (width == BIT_WIDTH_32) {
+      auto f = static_cast<float>(v);
+      uint32_t bits32;
+      memcpy(&bits32, &f, sizeof(bits32));
+      bits = bits32;
+    } else {
+      memcpy(&bits, &v, sizeof(bits));
+    }
+    return SetScalar(Slot(vec, i), FBT_FLOAT, bits, width);
+  }
+  bool SetString(const Vector& vec, size_t i, const char* str, size_t len) {
+    return SetString(Slot(vec, i), str, len);
+  }
+
+  bool SetInt(const Map& map, const char* key, int64_t v) {
+    return SetInt(map, Index(map, key), v);
+  }
+  bool SetUInt(const Map& map, const char* key, uint64_t v) {
+    return SetUInt(map, Index(map, key), v);
+  }
+  bool SetBool(const Map& map, const char* key, bool v) {
+    return SetBool(map, Index(map, key), v);
+  }
+  bool SetDouble(const Map& map, const char* key, double v) {
+    return SetDouble(map, Index(map, key), v);
+  }
+  bool SetString(const Map& map, const char* key, const char* str,
+                 size_t len) {
+    return SetString(map, Index(map, key), str, len);
+  }
+  bool SetString(const Map& map, const char* key, const char* str) {
+    return SetString(map, Index(map, key), str, strlen(str));
+  }
+
+  // Rebuilds the document without garbage, with a new slack region of
+  // `slack_size` bytes. Values are stored in at least `min_bit_width`, which
+  // leaves room for scalars to grow in place.
+  void Compact(size_t slack_size = 4096,
+               BitWidth min_bit_width = BIT_WIDTH_8) {
+    Builder fbb(size());
+    fbb.ForceMinimumBitWidth(min_bit_width);
+    Copy(GetRoot(), fbb);
+    fbb.Finish();
+    auto& doc = fbb.GetBuffer();
+    Reset(doc.data(), doc.size(), slack_size);
+  }
+
+ private:
+  // Where an element of a vector or map is stored.
+  struct ElementSlot {
+    uint8_t* data;
+    uint8_t byte_width;
+    // Null if there is no such element.
+    uint8_t* packed_type;
+  };
+
+  void Reset(const uint8_t* buf, size_t size, size_t slack_size) {
+    // Keep the document aligned as it was relative to the start of the
+    // buffer.
+    slack_size = (slack_size + 7) & ~static_cast<size_t>(7);
+    buf_.assign(slack_size, 0);
+    buf_.insert(buf_.end(), buf, buf + size);
+    slack_top_ = slack_size;
+    slack_end_ = slack_size;
+  }
+
+  // The buffer starts at the lowest multiple of 8 in use, so everything in
+  // it keeps its alignment.
+  size_t start() const { return slack_top_ & ~static_cast<size_t>(7); }
+
+  ElementSlot Slot(const Vector& vec, size_t i) {
+    ElementSlot slot = {nullptr, vec.byte_width_, nullptr};
+    if (i < vec.size()) {
+      slot.data = const_cast<uint8_t*>(vec.data_) + i * vec.byte_width_;
+      slot.packed_type = const_cast<uint8_t*>(vec.data_) +
+                         vec.size() * vec.byte_width_ + i;
+    }
+    return slot;
+  }
+
+  static size_t Index(const Map& map, const char* key) {
+    auto keys = map.Keys();
+    // Binary search, like Map::operator[].
+    size_t lo = 0;
+    size_t hi = keys.size();
+    while (lo < hi) {
+      auto mid = lo + (hi - lo) / 2;
+      auto comp = strcmp(key, keys[mid].AsKey());
+      if (!comp) return mid;
+      if (comp < 0) {
+        hi = mid;
+      } else {
+        lo = mid + 1;
+      }
+    }
+    return map.size();  // Not found.
+  }
+
+  // Whether `p` is in the part of the slack region in use.
+  bool InSlack(const char* p) const {
+    auto q = reinterpret_cast<const uint8_t*>(p);
+    return q >= buf_.data() + slack_top_ && q < buf_.data() + slack_end_;
+  }
+
+  // Reserves `size` bytes aligned to `alignment` in the slack region.
+  uint8_t* Allocate(size_t size, size_t alignment) {
+    if (size > slack_top_) return nullptr;
+    auto loc = (slack_top_ - size) & ~(alignment - 1);
+    slack_top_ = loc;
+    return buf_.data() + loc;
+  }
+
+  static BitWidth WidthOf(uint8_t byte_width) {
+    return byte_width == 1
+               ? BIT_WIDTH_8
+               : (byte_width == 2 ? BIT_WIDTH_16
+                                  : (byte_width == 4 ? BIT_WIDTH_32
+                                                     : BIT_WIDTH_64));
+  }
+
+  static void WriteUInt(uint8_t* dest, uint64_t u, size_t byte_width) {
+    uint8_t bytes[sizeof(uint64_t)];
+    flatbuffers::WriteScalar(bytes, u);
+    memcpy(dest, bytes, byte_width);
+  }
+
+  // Points `slot` at `target`, which must be before it.
+  static bool WriteOffset(const ElementSlot& slot, const uint8_t* target) {
+    auto offset = static_cast<uint64_t>(slot.data - target);
+    if (slot.byte_width < 8 && offset >> (slot.byte_width * 8)) return false;
+    WriteUInt(slot.data, offset, slot.byte_width);
+    return true;
+  }
+
+  bool SetScalar(const ElementSlot& slot, Type type, uint64_t bits,
+                 BitWidth width) {
+    if (!slot.packed_type) return false;
+    auto byte_width = static_cast<size_t>(1) << width;
+    if (byte_width <= slot.byte_width && (type != FBT_FLOAT ||
+                                          byte_width == slot.byte_width)) {
+      // Fits inline. Floats are only stored inline as wide as the element,
+      // anything else is widened (`bits` of an int are already sign
+      // extended).
+      WriteUInt(slot.data, bits, slot.byte_width);
+      *slot.packed_type = PackedType(WidthOf(slot.byte_width), type);
+      return true;
+    }
+    if (type == FBT_FLOAT && byte_width < slot.byte_width) {
+      // A float in a double's place.
+      float f;
+      uint32_t bits32 = static_cast<uint32_t>(bits);
+      memcpy(&f, &bits32, sizeof(f));
+      double d = f;
+      memcpy(&bits, &d, sizeof(bits));
+      WriteUInt(slot.data, bits, slot.byte_width);
+      *slot.packed_type = PackedType(WidthOf(slot.byte_width), type);
+      return true;
+    }
+    // Store it indirectly.
+    auto slack_top = slack_top_;
+    auto dest = Allocate(byte_width, byte_width);
+    if (!dest) return false;
+    if (!WriteOffset(slot, dest)) {
+      slack_top_ = slack_top;
+      return false;
+    }
+    WriteUInt(dest, bits, byte_width);
+    auto indirect_type = type == FBT_INT
+                             ? FBT_INDIRECT_INT
+                             : (type == FBT_UINT ? FBT_INDIRECT_UINT
+                                                 : FBT_INDIRECT_FLOAT);
+    *slot.packed_type = PackedType(width, indirect_type);
+    return true;
+  }
+
+  bool SetString(const ElementSlot& slot, const char* str, size_t len) {
+    if (!slot.packed_type) return false;
+    // Strings of the document may be shared by several elements (see
+    // BUILDER_FLAG_SHARE_STRINGS), so only the ones written to the slack
+    // region, which belong to a single element, are edited in place.
+    auto current = Reference(slot.data, slot.byte_width, *slot.packed_type);
+    if (current.IsString() && InSlack(current.AsString().c_str()) &&
+        current.MutateString(str, len)) {
+      return true;
+    }
+    auto width = WidthU(len);
+    auto byte_width = static_cast<size_t>(1) << width;
+    auto slack_top = slack_top_;
+    auto dest = Allocate(byte_width + len + 1, byte_width);
+    if (!dest) return false;
+    if (!WriteOffset(slot, dest + byte_width)) {
+      slack_top_ = slack_top;
+      return false;
+    }
+    WriteUInt(dest, len, byte_width);
+    memcpy(dest + byte_width, str, len);
+    dest[byte_width + len] = 0;
+    *slot.packed_type = PackedType(width, FBT_STRING);
+    return true;
+  }
+
+  static void Copy(Reference r, Builder& fbb) {
+    switch (r.GetType()) {
+      case FBT_NULL:
+        fbb.Null();
+        break;
+      case FBT_INT:
+        fbb.Int(r.AsInt64());
+        break;
+      case FBT_UINT:
+        fbb.UInt(r.AsUInt64());
+        break;
+      case FBT_FLOAT:
+        fbb.Double(r.AsDouble());
+        break;
+      case FBT_BOOL:
+        fbb.Bool(r.AsBool());
+        break;
+      case FBT_INDIRECT_INT:
+        fbb.IndirectInt(r.AsInt64());
+        break;
+      case FBT_INDIRECT_UINT:
+        fbb.IndirectUInt(r.AsUInt64());
+        break;
+      case FBT_INDIRECT_FLOAT:
+        if (r.byte_width_ == sizeof(float)) {
+          fbb.IndirectFloat(static_cast<float>(r.AsDouble()));
+        } else {
+          fbb.IndirectDouble(r.AsDouble());
+        }
+        break;
+      case FBT_KEY:
+        fbb.Key(r.AsKey());
+        break;
+      case FBT_STRING: {
+        auto str = r.AsString();
+        fbb.String(str.c_str(), str.size());
+        break;
+      }
+      case FBT_BLOB: {
+        auto blob = r.AsBlob();
+        fbb.Blob(blob.data(), blob.size());
+        break;
+      }
+      case FBT_MAP: {
+        auto map = r.AsMap();
+        auto keys = map.Keys();
+        auto values = map.Values();
+        auto start = fbb.StartMap();
+        for (size_t i = 0; i < map.size(); i++) {
+          fbb.Key(keys[i].AsKey());
+          Copy(values[i], fbb);
+        }
+        fbb.EndMap(start);
+        break;
+      }
+      case FBT_VECTOR: {
+        auto vec = r.AsVector();
+        auto start = fbb.StartVector();
+        for (size_t i = 0; i < vec.size(); i++) Copy(vec[i], fbb);
+        fbb.EndVector(start, false, false);
+        break;
+      }
+      case FBT_VECTOR_STRING_DEPRECATED: {
+        // Written as a vector of strings.
+        auto vec = r.AsTypedVector();
+        auto start = fbb.StartVector();
+        for (size_t i = 0; i < vec.size(); i++) fbb.String(vec[i].AsKey());
+        fbb.EndVector(start, false, false);
+        break;
+      }
+      default:
+        if (r.IsTypedVector()) {
+          auto vec = r.AsTypedVector();
+          auto start = fbb.StartVector();
+          for (size_t i = 0; i < vec.size(); i++) Copy(vec[i], fbb);
+          fbb.EndVector(start, true, false);
+        } else {
+          auto vec = r.AsFixedTypedVector();
+          auto start = fbb.StartVector();
+          for (size_t i = 0; i < vec.size(); i++) Copy(vec[i], fbb);
+          fbb.EndVector(start, true, true);
+        }
+        break;
+    }
+  }
+
+  // [slack region][document], where the part of the slack region in use
+  // starts at slack_top_, and the document at slack_end_.
+  std::vector<uint8_t> buf_;
+  size_t slack_top_;
+  size_t slack_end_;
+};
+
+// Memory for the Verifier to track which parts of a buffer it has verified
+// already, like the `reuse_tracker` vector, that can be used for verifying
+// many buffers in turn. Only the entries a verification set are cleared for
+// the next one, instead of memory the size of the whole buffer, and nothing
+// is allocated once it has seen the largest buffer.
+class VerifierReuseTracker FLATBUFFERS_FINAL_CLASS {
+ public:
+  VerifierReuseTracker() {}
+
+ private:
+  friend class Verifier;
+
+  uint8_t* Prepare(size_t size) {
+    for (auto it = touched_.begin(); it != touched_.end(); ++it) {
+      types_[*it] = PackedType(BIT_WIDTH_8, FBT_NULL);
+    }
+    touched_.clear();
+    if (types_.size() < size) {
+      types_.resize(size, PackedType(BIT_WIDTH_8, FBT_NULL));
+    }
+    return types_.data();
+  }
+
+  std::vector<uint8_t> types_;
+  std::vector<size_t> touched_;
+};
+
 // Helper class to verify the integrity of a FlexBuffer
 class Verifier FLATBUFFERS_FINAL_CLASS {
  public:
@@ -1843,15 +2686,43 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
         num_vectors_(0),
         max_vectors_(buf_len),
         check_alignment_(_check_alignment),
-        reuse_tracker_(reuse_tracker) {
+        reuse_types_(nullptr),
+        reuse_touched_(nullptr),
+        parallel_for_(nullptr),
+        parallel_for_context_(nullptr),
+        parallel_min_elems_(0) {
     FLATBUFFERS_ASSERT(static_cast<int32_t>(size_) <
                        FLATBUFFERS_MAX_BUFFER_SIZE);
-    if (reuse_tracker_) {
-      reuse_tracker_->clear();
-      reuse_tracker_->resize(size_, PackedType(BIT_WIDTH_8, FBT_NULL));
+    if (reuse_tracker) {
+      reuse_tracker->clear();
+      reuse_tracker->resize(size_, PackedType(BIT_WIDTH_8, FBT_NULL));
+      reuse_types_ = reuse_tracker->data();
     }
   }
 
+  // As above, but tracks reuse in memory kept by `reuse_tracker`, which can
+  // be used again for the next buffer.
+  Verifier(const uint8_t* buf, size_t buf_len,
+           VerifierReuseTracker& reuse_tracker, bool _check_alignment = true,
+           size_t max_depth = 64)
+      : Verifier(buf, buf_len, nullptr, _check_alignment, max_depth) {
+    reuse_types_ = reuse_tracker.Prepare(size_);
+    reuse_touched_ = &reuse_tracker.touched_;
+  }
+
+  // Verifies the elements of vectors and maps of at least `2 * min_elems`
+  // elements in tasks of `min_elems` elements each, by calling
+  // `parallel_for` with `context` and the number of tasks.
+  // Tasks don't use the reuse tracker. If any task fails, the vector is
+  // verified again serially, so the same check fails as would have without
+  // parallelism.
+  void SetParallelFor(flatbuffers::ParallelFor parallel_for, void* context,
+                      size_t min_elems = 1024) {
+    parallel_for_ = parallel_for;
+    parallel_for_context_ = context;
+    parallel_min_elems_ = min_elems;
+  }
+
  private:
   // Central location where any verification failures register.
   bool Check(bool ok) const {
@@ -1898,26 +2769,34 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
 
 // Macro, since we want to escape from parent function & use lazy args.
 #define FLEX_CHECK_VERIFIED(P, PACKED_TYPE)                     \
-  if (reuse_tracker_) {                                         \
+  if (reuse_types_) {                                           \
     auto packed_type = PACKED_TYPE;                             \
-    auto existing = (*reuse_tracker_)[P - buf_];                \
+    auto existing = reuse_types_[P - buf_];                     \
     if (existing == packed_type) return true;                   \
     /* Fail verification if already set with different type! */ \
     if (!Check(existing == 0)) return false;                    \
-    (*reuse_tracker_)[P - buf_] = packed_type;                  \
+    SetVerified(P, packed_type);                                \
+  }
+
+  void SetVerified(const uint8_t* p, uint8_t packed_type) {
+    auto o = static_cast<size_t>(p - buf_);
+    reuse_types_[o] = packed_type;
+    if (reuse_touched_) reuse_touched_->push_back(o);
   }
 
   bool VerifyVector(Reference r, const uint8_t* p, Type elem_type) {
     // Any kind of nesting goes thru this function, so guard against that
     // here, both with simple nesting checks, and the reuse tracker if on.
-    depth_++;
-    num_vectors_++;
-    if (!Check(depth_ <= max_depth_ && num_vectors_ <= max_vectors_))
-      return false;
     auto size_byte_width = r.byte_width_;
     if (!VerifyBeforePointer(p, size_byte_width)) return false;
+    // Check this before going deeper, since we return early if it was
+    // verified already.
     FLEX_CHECK_VERIFIED(p - size_byte_width,
                         PackedType(Builder::WidthB(size_byte_width), r.type_));
+    depth_++;
+    num_vectors_++;
+    if (!Check(depth_ <= max_depth_ && num_vectors_ <= max_vectors_))
+      return false;
     auto sized = Sized(p, size_byte_width);
     auto num_elems = sized.size();
     auto elem_byte_width = r.type_ == FBT_STRING || r.type_ == FBT_BLOB
@@ -1932,12 +2811,10 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
       // Verify type bytes after the vector.
       if (!VerifyFromPointer(p + byte_size, num_elems)) return false;
       auto v = Vector(p, size_byte_width);
-      for (size_t i = 0; i < num_elems; i++)
-        if (!VerifyRef(v[i])) return false;
+      if (!VerifyElements(v, num_elems)) return false;
     } else if (elem_type == FBT_KEY) {
       auto v = TypedVector(p, elem_byte_width, FBT_KEY);
-      for (size_t i = 0; i < num_elems; i++)
-        if (!VerifyRef(v[i])) return false;
+      if (!VerifyElements(v, num_elems)) return false;
     } else {
       FLATBUFFERS_ASSERT(IsInline(elem_type));
     }
@@ -1945,6 +2822,75 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
     return true;
   }
 
+  template <typename V>
+  bool VerifyElements(const V& v, size_t num_elems) {
+    if (parallel_for_ && parallel_min_elems_ &&
+        num_elems / 2 >= parallel_min_elems_) {
+      return VerifyElementsInParallel(v, num_elems);
+    }
+    for (size_t i = 0; i < num_elems; i++)
+      if (!VerifyRef(v[i])) return false;
+    return true;
+  }
+
+  // Like VerifierTemplate::VerifyVectorOfTablesInParallel(), each task may
+  // verify an equal share of the vectors left below max_vectors_.
+  template <typename V>
+  bool VerifyElementsInParallel(const V& v, size_t num_elems) {
+    struct TaskResult {
+      bool ok;
+      size_t num_vectors;
+    };
+    struct Tasks {
+      Verifier* verifier;
+      const V* v;
+      size_t num_elems;
+      size_t max_vectors;
+      std::vector<TaskResult> results;
+
+      static void Run(void* tasks, size_t task) {
+        static_cast<Tasks*>(tasks)->Verify(task);
+      }
+
+      void Verify(size_t task) {
+        Verifier task_verifier(verifier->buf_, verifier->size_, nullptr,
+                               verifier->check_alignment_,
+                               verifier->max_depth_);
+        task_verifier.depth_ = verifier->depth_;
+        task_verifier.max_vectors_ = max_vectors;
+        const size_t task_size = verifier->parallel_min_elems_;
+        const size_t begin = task * task_size;
+        const size_t end = (std::min)(num_elems, begin + task_size);
+        auto& result = results[task];
+        result.ok = true;
+        for (size_t i = begin; result.ok && i < end; i++) {
+          result.ok = task_verifier.VerifyRef((*v)[i]);
+        }
+        result.num_vectors = task_verifier.num_vectors_;
+      }
+    };
+    const size_t task_size = parallel_min_elems_;
+    const size_t num_tasks = (num_elems + task_size - 1) / task_size;
+    Tasks tasks;
+    tasks.verifier = this;
+    tasks.v = &v;
+    tasks.num_elems = num_elems;
+    tasks.max_vectors = (max_vectors_ - num_vectors_) / num_tasks;
+    tasks.results.resize(num_tasks);
+    parallel_for_(parallel_for_context_, num_tasks, Tasks::Run, &tasks);
+    bool ok = true;
+    for (size_t i = 0; i < num_tasks; i++) ok = ok && tasks.results[i].ok;
+    if (!ok) {
+      for (size_t i = 0; i < num_elems; i++)
+        if (!VerifyRef(v[i])) return false;
+      return true;
+    }
+    for (size_t i = 0; i < num_tasks; i++) {
+      num_vectors_ += tasks.results[i].num_vectors;
+    }
+    return true;
+  }
+
   bool VerifyKeys(const uint8_t* p, uint8_t byte_width) {
     // The vector part of the map has already been verified.
     const size_t num_prefixed_fields = 3;
@@ -2050,9 +2996,16 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
   size_t depth_;
   const size_t max_depth_;
   size_t num_vectors_;
-  const size_t max_vectors_;
+  // Not const, since tasks verifying in parallel each get a share of it.
+  size_t max_vectors_;
   bool check_alignment_;
-  std::vector<uint8_t>* reuse_tracker_;
+  uint8_t* reuse_types_;
+  // Entries of reuse_types_ to clear before the next use, if it belongs to a
+  // VerifierReuseTracker.
+  std::vector<size_t>* reuse_touched_;
+  flatbuffers::ParallelFor parallel_for_;
+  void* parallel_for_context_;
+  size_t parallel_min_elems_;
 };
 
 // Utility function that constructs the Verifier for you, see above for
@@ -2063,6 +3016,12 @@ inline bool VerifyBuffer(const uint8_t* buf, size_t buf_len,
   return verifier.VerifyBuffer();
 }
 
+inline bool VerifyBuffer(const uint8_t* buf, size_t buf_len,
+                         VerifierReuseTracker& reuse_tracker) {
+  Verifier verifier(buf, buf_len, reuse_tracker);
+  return verifier.VerifyBuffer();
+}
+
 }  // namespace flexbuffers
 
 #if defined(_MSC_VER)
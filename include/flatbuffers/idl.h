@@ -227,10 +227,17 @@ struct Type {
 struct Value {
   Value()
       : constant("0"),
-        offset(static_cast<voffset_t>(~(static_cast<voffset_t>(0U)))) {}
+        offset(static_cast<voffset_t>(~(static_cast<voffset_t>(0U)))),
+        has_binary(false),
+        binary(0) {}
   Type type;
   std::string constant;
   voffset_t offset;
+  // When parsing JSON, scalars and offsets are converted once, and kept here
+  // (as the bits of the C type of `type`, or the offset) rather than in
+  // `constant`, which is then out of date.
+  bool has_binary;
+  uint64_t binary;
 };
 
 // Helper class that retains the original order of a set of identifiers and
@@ -673,6 +680,7 @@ struct IDLOptions {
   bool generate_name_strings;
   bool generate_object_based_api;
   bool gen_compare;
+  bool gen_fixed_create;
   bool gen_absl_hash;
   std::string cpp_object_api_pointer_type;
   std::string cpp_object_api_string_type;
@@ -833,6 +841,7 @@ struct IDLOptions {
         generate_name_strings(false),
         generate_object_based_api(false),
         gen_compare(false),
+        gen_fixed_create(false),
         gen_absl_hash(false),
         cpp_object_api_pointer_type("std::unique_ptr"),
         cpp_object_api_string_flexible_constructor(false),
@@ -1009,6 +1018,7 @@ class Parser : public ParserState {
     known_attributes_["bit_flags"] = true;
     known_attributes_["original_order"] = true;
     known_attributes_["nested_flatbuffer"] = true;
+    known_attributes_["eytzinger"] = true;
     known_attributes_["csharp_partial"] = true;
     known_attributes_["streaming"] = true;
     known_attributes_["idempotent"] = true;
@@ -1203,6 +1213,7 @@ class Parser : public ParserState {
                                       const char** include_paths,
                                       const char* source_filename);
   FLATBUFFERS_CHECKED_ERROR CheckPrivateLeak();
+  FLATBUFFERS_CHECKED_ERROR SetBinaryDefaults();
   FLATBUFFERS_CHECKED_ERROR CheckPrivatelyLeakedFields(
       const Definition& def, const Definition& value_type);
   FLATBUFFERS_CHECKED_ERROR DoParse(const char* _source,
@@ -1222,6 +1233,7 @@ class Parser : public ParserState {
   bool SupportsDefaultVectorsAndStrings() const;
   bool Supports64BitOffsets() const;
   bool SupportsUnionUnderlyingType() const;
+  bool SupportsEytzingerVectors() const;
   Namespace* UniqueNamespace(Namespace* ns);
 
   FLATBUFFERS_CHECKED_ERROR RecurseError();
@@ -1274,6 +1286,45 @@ class Parser : public ParserState {
   int parse_depth_counter_;  // stack-overflow guard
 };
 
+// Decodes JSON documents of a single schema into FlatBuffers, one after the
+// other. Unlike Parser::ParseJson(), the result goes into a FlatBufferBuilder
+// owned by the caller, and the state needed for parsing is kept between
+// documents, so when the builder is reused most of the memory for decoding
+// is allocated once rather than for every document. Some tokens still
+// allocate, such as numbers too long for a std::string to hold inline.
+// A decoder is not thread-safe, make one per thread.
+class JsonDecoder {
+ public:
+  // From a binary schema (.bfbs), as written by Parser::Serialize().
+  JsonDecoder(const uint8_t* bfbs, size_t size,
+              const IDLOptions& opts = IDLOptions());
+
+  explicit JsonDecoder(const reflection::Schema* schema,
+                       const IDLOptions& opts = IDLOptions());
+
+  // From a parser that has parsed a schema, using its options. This calls
+  // schema.Serialize(), which replaces the contents of schema.builder_.
+  explicit JsonDecoder(Parser& schema);
+
+  // Whether the schema could be loaded. If not, Decode() always fails.
+  bool ok() const { return ok_; }
+
+  // Use a root type other than the one declared by the schema.
+  bool SetRootType(const char* name) { return parser_.SetRootType(name); }
+
+  // Clears `builder` and decodes `json` into it as a finished buffer.
+  // Returns false on error, see error().
+  bool Decode(const char* json, FlatBufferBuilder& builder,
+              const char* json_filename = nullptr);
+
+  // User readable error if Decode() or loading the schema failed.
+  const std::string& error() const { return parser_.error_; }
+
+ private:
+  Parser parser_;
+  bool ok_;
+};
+
 // Utility functions for multiple generators:
 
 // Generate text (JSON) from a given FlatBuffer, and a given Parser
@@ -1302,6 +1353,17 @@ extern const char* GenText(const Parser& parser, const void* flatbuffer,
 extern const char* GenTextFile(const Parser& parser, const std::string& path,
                                const std::string& file_name);
 
+// As GenTextFromTable() and GenText() above, but the text is written to
+// `sink` in parts as it is generated, holding on to about `buffer_size`
+// bytes at a time (more for a single string or FlexBuffer that is larger).
+// Returns an error if writing to the sink fails.
+extern const char* GenTextFromTable(const Parser& parser, const void* table,
+                                    const std::string& tablename,
+                                    BufferSink& sink,
+                                    size_t buffer_size = 64 * 1024);
+extern const char* GenText(const Parser& parser, const void* flatbuffer,
+                           BufferSink& sink, size_t buffer_size = 64 * 1024);
+
 // Generate GRPC Cpp interfaces.
 // See idl_gen_grpc.cpp.
 bool GenerateCppGRPC(const Parser& parser, const std::string& path,
@@ -0,0 +1,35 @@
+/*
+ * Copyright 2024 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLATBUFFERS_PARALLEL_FOR_H_
+#define FLATBUFFERS_PARALLEL_FOR_H_
+
+#include "flatbuffers/base.h"
+
+namespace flatbuffers {
+
+// Lets the verifiers split large vectors into tasks that run on the caller's
+// threads. It must call `task(task_context, i)` once for every `i` below
+// `num_tasks`, possibly from other threads, and return when all calls are
+// done. `context` is what was passed along with the function, e.g. a thread
+// pool owned by the caller.
+typedef void (*ParallelFor)(void* context, size_t num_tasks,
+                            void (*task)(void* task_context, size_t i),
+                            void* task_context);
+
+}  // namespace flatbuffers
+
+#endif  // FLATBUFFERS_PARALLEL_FOR_H_
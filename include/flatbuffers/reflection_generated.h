@@ -277,9 +277,7 @@ struct KeyValue FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
   }
   template<typename StringType>
   int KeyCompareWithValue(const StringType& _key) const {
-    if (key()->c_str() < _key) return -1;
-    if (_key < key()->c_str()) return 1;
-    return 0;
+    return ::flatbuffers::CompareStringKey(*key(), _key);
   }
   const ::flatbuffers::String *value() const {
     return GetPointer<const ::flatbuffers::String *>(VT_VALUE);
@@ -475,9 +473,7 @@ struct Enum FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
   }
   template<typename StringType>
   int KeyCompareWithValue(const StringType& _name) const {
-    if (name()->c_str() < _name) return -1;
-    if (_name < name()->c_str()) return 1;
-    return 0;
+    return ::flatbuffers::CompareStringKey(*name(), _name);
   }
   const ::flatbuffers::Vector<::flatbuffers::Offset<reflection::EnumVal>> *values() const {
     return GetPointer<const ::flatbuffers::Vector<::flatbuffers::Offset<reflection::EnumVal>> *>(VT_VALUES);
@@ -634,9 +630,7 @@ struct Field FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
   }
   template<typename StringType>
   int KeyCompareWithValue(const StringType& _name) const {
-    if (name()->c_str() < _name) return -1;
-    if (_name < name()->c_str()) return 1;
-    return 0;
+    return ::flatbuffers::CompareStringKey(*name(), _name);
   }
   const reflection::Type *type() const {
     return GetPointer<const reflection::Type *>(VT_TYPE);
@@ -859,9 +853,7 @@ struct Object FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
   }
   template<typename StringType>
   int KeyCompareWithValue(const StringType& _name) const {
-    if (name()->c_str() < _name) return -1;
-    if (_name < name()->c_str()) return 1;
-    return 0;
+    return ::flatbuffers::CompareStringKey(*name(), _name);
   }
   const ::flatbuffers::Vector<::flatbuffers::Offset<reflection::Field>> *fields() const {
     return GetPointer<const ::flatbuffers::Vector<::flatbuffers::Offset<reflection::Field>> *>(VT_FIELDS);
@@ -1018,9 +1010,7 @@ struct RPCCall FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
   }
   template<typename StringType>
   int KeyCompareWithValue(const StringType& _name) const {
-    if (name()->c_str() < _name) return -1;
-    if (_name < name()->c_str()) return 1;
-    return 0;
+    return ::flatbuffers::CompareStringKey(*name(), _name);
   }
   const reflection::Object *request() const {
     return GetPointer<const reflection::Object *>(VT_REQUEST);
@@ -1141,9 +1131,7 @@ struct Service FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
   }
   template<typename StringType>
   int KeyCompareWithValue(const StringType& _name) const {
-    if (name()->c_str() < _name) return -1;
-    if (_name < name()->c_str()) return 1;
-    return 0;
+    return ::flatbuffers::CompareStringKey(*name(), _name);
   }
   const ::flatbuffers::Vector<::flatbuffers::Offset<reflection::RPCCall>> *calls() const {
     return GetPointer<const ::flatbuffers::Vector<::flatbuffers::Offset<reflection::RPCCall>> *>(VT_CALLS);
@@ -1267,9 +1255,7 @@ struct SchemaFile FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
   }
   template<typename StringType>
   int KeyCompareWithValue(const StringType& _filename) const {
-    if (filename()->c_str() < _filename) return -1;
-    if (_filename < filename()->c_str()) return 1;
-    return 0;
+    return ::flatbuffers::CompareStringKey(*filename(), _filename);
   }
   /// Names of included files, relative to project root.
   const ::flatbuffers::Vector<::flatbuffers::Offset<::flatbuffers::String>> *included_filenames() const {
@@ -82,6 +82,7 @@ namespace flatbuffers {
   template <typename T, typename U> using is_same = std::is_same<T,U>;
   template <typename T> using is_floating_point = std::is_floating_point<T>;
   template <typename T> using is_unsigned = std::is_unsigned<T>;
+  template <typename T> using is_integral = std::is_integral<T>;
   template <typename T> using is_enum = std::is_enum<T>;
   template <typename T> using make_unsigned = std::make_unsigned<T>;
   template<bool B, class T, class F>
@@ -99,6 +100,7 @@ namespace flatbuffers {
   template <typename T> struct is_floating_point :
         public std::is_floating_point<T> {};
   template <typename T> struct is_unsigned : public std::is_unsigned<T> {};
+  template <typename T> struct is_integral : public std::is_integral<T> {};
   template <typename T> struct is_enum : public std::is_enum<T> {};
   template <typename T> struct make_unsigned : public std::make_unsigned<T> {};
   template<bool B, class T, class F>
@@ -44,6 +44,36 @@ struct String : public Vector<char> {
   }
 };
 
+// Compares a String key with a key to look up, for the KeyCompareWithValue()
+// functions of generated code.
+inline int CompareStringKey(const String& key, const std::string& value) {
+  return StringCompare(key.c_str(), key.size(), value.data(), value.size());
+}
+
+#ifdef FLATBUFFERS_HAS_STRING_VIEW
+inline int CompareStringKey(const String& key, flatbuffers::string_view value) {
+  return StringCompare(key.c_str(), key.size(), value.data(), value.size());
+}
+#endif  // FLATBUFFERS_HAS_STRING_VIEW
+
+// Mutable C-strings and char arrays would otherwise pick the template below,
+// and compare addresses.
+inline int CompareStringKey(const String& key, char* value) {
+  return strcmp(key.c_str(), value);
+}
+template <size_t N>
+int CompareStringKey(const String& key, const char (&value)[N]) {
+  return strcmp(key.c_str(), value);
+}
+
+// Any other string type must be comparable with const char* instead.
+template <typename StringType>
+int CompareStringKey(const String& key, const StringType& value) {
+  if (key.c_str() < value) return -1;
+  if (value < key.c_str()) return 1;
+  return 0;
+}
+
 // Convenience function to get std::string from a String returning an empty
 // string on null pointer.
 static inline std::string GetString(const String* str) {
@@ -35,6 +35,10 @@
 #include <limits>
 #include <string>
 
+#if defined(FLATBUFFERS_HAS_FLOAT_CHARCONV) && (FLATBUFFERS_HAS_FLOAT_CHARCONV > 0)
+#include <charconv>
+#endif
+
 namespace flatbuffers {
 
 // @locale-independent functions for ASCII characters set.
@@ -124,11 +128,41 @@ std::string NumToStringImplWrapper(T t, const char* fmt, int precision = 0) {
 }
 #endif  // FLATBUFFERS_PREFER_PRINTF
 
-// Convert an integer or floating point value to a string.
-// In contrast to std::stringstream, "char" values are
-// converted to a string of digits, and we don't use scientific notation.
+// Writes the decimal digits of `v` to the chars before `end`, and returns
+// where they start.
+inline char* WriteDecimalDigits(uint64_t v, char* end) {
+  do {
+    *--end = static_cast<char>('0' + v % 10);
+    v /= 10;
+  } while (v);
+  return end;
+}
+
+inline std::string IntegerToString(uint64_t v) {
+  char buf[20];
+  auto end = buf + sizeof(buf);
+  return std::string(WriteDecimalDigits(v, end), end);
+}
+
+inline std::string IntegerToString(int64_t v) {
+  char buf[21];
+  auto end = buf + sizeof(buf);
+  // Negate as unsigned, which also works for the lowest value.
+  auto p = WriteDecimalDigits(
+      v < 0 ? 0 - static_cast<uint64_t>(v) : static_cast<uint64_t>(v), end);
+  if (v < 0) *--p = '-';
+  return std::string(p, end);
+}
+
 template <typename T>
-std::string NumToString(T t) {
+std::string NumToStringImpl(T t, true_type /*is_integral*/) {
+  typedef typename conditional<is_unsigned<T>::value, uint64_t, int64_t>::type
+      type64;
+  return IntegerToString(static_cast<type64>(t));
+}
+
+template <typename T>
+std::string NumToStringImpl(T t, false_type /*is_integral*/) {
   // clang-format off
 
   #ifndef FLATBUFFERS_PREFER_PRINTF
@@ -141,6 +175,15 @@ std::string NumToString(T t) {
   #endif // FLATBUFFERS_PREFER_PRINTF
   // clang-format on
 }
+
+// Convert an integer or floating point value to a string.
+// In contrast to std::stringstream, "char" values are
+// converted to a string of digits, and we don't use scientific notation.
+// Integers are formatted directly, without locale or stream overhead.
+template <typename T>
+std::string NumToString(T t) {
+  return NumToStringImpl(t, bool_constant<is_integral<T>::value>());
+}
 // Avoid char types used as character data.
 template <>
 inline std::string NumToString<signed char>(signed char t) {
@@ -160,6 +203,25 @@ template <typename T>
 std::string FloatToString(T t, int precision) {
   // clang-format off
 
+  #if defined(FLATBUFFERS_HAS_FLOAT_CHARCONV) && (FLATBUFFERS_HAS_FLOAT_CHARCONV > 0)
+    // Same output as std::fixed, without the stream. Only huge numbers don't
+    // fit, those take the slow path below.
+    char buf[64];
+    auto res = std::to_chars(buf, buf + sizeof(buf), t,
+                             std::chars_format::fixed, precision);
+    if (res.ec == std::errc()) {
+      // Strip trailing zeroes, as below.
+      auto end = res.ptr;
+      while (end > buf && end[-1] == '0') end--;
+      if (end == buf) {
+        end = res.ptr;
+      } else if (end[-1] == '.') {
+        end++;
+      }
+      return std::string(buf, end);
+    }
+  #endif
+
   #ifndef FLATBUFFERS_PREFER_PRINTF
     // to_string() prints different numbers of digits for floats depending on
     // platform and isn't available on Android, so we use stringstream
@@ -276,6 +338,31 @@ inline void strtoval_impl(float *val, const char *str, char **endptr) {
 #undef __strtof_impl
 // clang-format on
 
+// Converts a string of at most 18 decimal digits with an optional sign, which
+// is most numbers and can't overflow, without going through strtoll().
+// Returns false for anything else, leaving `*val` alone.
+inline bool ShortDecimalToInteger(int64_t* val, const char* str) {
+  const auto negative = *str == '-';
+  if (negative || *str == '+') str++;
+  uint64_t v = 0;
+  auto s = str;
+  for (; is_digit(*s); s++) v = v * 10 + static_cast<uint64_t>(*s - '0');
+  if (*s || s == str || s - str > 18) return false;
+  *val = negative ? -static_cast<int64_t>(v) : static_cast<int64_t>(v);
+  return true;
+}
+
+// As above, but without a minus sign, and with up to 19 digits.
+inline bool ShortDecimalToInteger(uint64_t* val, const char* str) {
+  if (*str == '+') str++;
+  uint64_t v = 0;
+  auto s = str;
+  for (; is_digit(*s); s++) v = v * 10 + static_cast<uint64_t>(*s - '0');
+  if (*s || s == str || s - str > 19) return false;
+  *val = v;
+  return true;
+}
+
 // Adaptor for strtoull()/strtoll().
 // Flatbuffers accepts numbers with any count of leading zeros (-009 is -9),
 // while strtoll with base=0 interprets first leading zero as octal prefix.
@@ -302,6 +389,7 @@ inline bool StringToIntegerImpl(T* val, const char* const str,
     // if a prefix not match, try base=10
     return StringToIntegerImpl(val, str, 10, check_errno);
   } else {
+    if (base == 10 && ShortDecimalToInteger(val, str)) return true;
     if (check_errno) errno = 0;  // clear thread-local errno
     auto endptr = str;
     strtoval_impl(val, str, const_cast<char**>(&endptr), base);
@@ -319,6 +407,22 @@ template <typename T>
 inline bool StringToFloatImpl(T* val, const char* const str) {
   // Type T must be either float or double.
   FLATBUFFERS_ASSERT(str && val);
+  // clang-format off
+  #if defined(FLATBUFFERS_HAS_FLOAT_CHARCONV) && (FLATBUFFERS_HAS_FLOAT_CHARCONV > 0)
+    {
+      // std::from_chars() is correctly rounded like strtod(), but doesn't
+      // take a '+' sign, leading blanks or hex prefixes. Those (and errors)
+      // are left to strtod().
+      auto s = str[0] == '+' && str[1] != '-' && str[1] != '+' ? str + 1 : str;
+      auto last = s + strlen(s);
+      auto res = std::from_chars(s, last, *val);
+      if (res.ec == std::errc() && res.ptr == last) {
+        if (std::isnan(*val)) *val = std::numeric_limits<T>::quiet_NaN();
+        return true;
+      }
+    }
+  #endif
+  // clang-format on
   auto end = str;
   strtoval_impl(val, str, const_cast<char**>(&end));
   auto done = (end != str) && (*end == '\0');
@@ -736,6 +840,31 @@ inline std::string BufferToHexText(const void* buffer, size_t buffer_size,
   return text;
 }
 
+// Sorts the elements of `width` T's in [begin, end), where `comparator(a, b)`
+// returns whether a < b and `swapper(a, b)` exchanges two elements. Used where
+// std::sort can't be: for structs the size is only known at runtime, and
+// serialized offsets can't be swapped by value. The JSON parser and
+// FlexToFlatBuffer() both sort keyed vectors with it, so they agree on the
+// order of elements with equal keys.
+template <typename T, typename F, typename S>
+void SimpleQsort(T* begin, T* end, size_t width, F comparator, S swapper) {
+  if (end - begin <= static_cast<ptrdiff_t>(width)) return;
+  auto l = begin + width;
+  auto r = end;
+  while (l < r) {
+    if (comparator(begin, l)) {
+      r -= width;
+      swapper(l, r);
+    } else {
+      l += width;
+    }
+  }
+  l -= width;
+  swapper(begin, l);
+  SimpleQsort(begin, l, width, comparator, swapper);
+  SimpleQsort(r, end, width, comparator, swapper);
+}
+
 // Remove paired quotes in a string: "text"|'text' -> text.
 std::string RemoveStringQuotes(const std::string& s);
 
@@ -19,8 +19,10 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <vector>
 
 #include "flatbuffers/base.h"
+#include "flatbuffers/buffer_sink.h"
 #include "flatbuffers/default_allocator.h"
 #include "flatbuffers/detached_buffer.h"
 
@@ -47,7 +49,11 @@ class vector_downward {
         size_(0),
         buf_(nullptr),
         cur_(nullptr),
-        scratch_(nullptr) {}
+        scratch_(nullptr),
+        sink_(nullptr),
+        sink_failed_(false),
+        flushed_(0),
+        flush_limit_((std::numeric_limits<SizeT>::max)()) {}
 
   vector_downward(vector_downward&& other) noexcept
       // clang-format on
@@ -60,7 +66,12 @@ class vector_downward {
         size_(other.size_),
         buf_(other.buf_),
         cur_(other.cur_),
-        scratch_(other.scratch_) {
+        scratch_(other.scratch_),
+        sink_(other.sink_),
+        sink_failed_(other.sink_failed_),
+        flushed_(other.flushed_),
+        flush_limit_(other.flush_limit_),
+        flushed_segments_(std::move(other.flushed_segments_)) {
     // No change in other.allocator_
     // No change in other.initial_size_
     // No change in other.buffer_minalign_
@@ -97,6 +108,10 @@ class vector_downward {
     }
     size_ = 0;
     clear_scratch();
+    sink_failed_ = false;
+    flushed_ = 0;
+    clear_flush_limit();
+    flushed_segments_.clear();
   }
 
   void clear_scratch() { scratch_ = buf_; }
@@ -116,6 +131,8 @@ class vector_downward {
 
   // Relinquish the pointer to the caller.
   uint8_t* release_raw(size_t& allocated_bytes, size_t& offset) {
+    // A streamed buffer is only partially in memory.
+    FLATBUFFERS_ASSERT(!flushed_);
     auto* buf = buf_;
     allocated_bytes = reserved_;
     offset = vector_downward::offset();
@@ -129,6 +146,7 @@ class vector_downward {
 
   // Relinquish the pointer to the caller.
   DetachedBuffer release() {
+    FLATBUFFERS_ASSERT(!flushed_);
     // allocator ownership (if any) is transferred to DetachedBuffer.
     DetachedBuffer fb(allocator_, own_allocator_, buf_, reserved_, cur_,
                       size());
@@ -195,7 +213,53 @@ class vector_downward {
     return scratch_;
   }
 
-  uint8_t* data_at(size_t offset) const { return buf_ + reserved_ - offset; }
+  uint8_t* data_at(size_t offset) const {
+    return buf_ + reserved_ - (offset - flushed_);
+  }
+
+  // When a sink is set, the oldest data is written to it whenever the buffer
+  // runs out of space, and dropped from memory, rather than growing the
+  // buffer. Offsets keep counting from the end of all data, including what was
+  // written to the sink.
+  void set_sink(BufferSink* sink) { sink_ = sink; }
+
+  BufferSink* sink() const { return sink_; }
+
+  // Whether any write to the sink failed since the last clear().
+  bool sink_failed() const { return sink_failed_; }
+
+  // Keeps the newest `size() - limit` bytes in memory when flushing
+  // automatically, e.g. an object that is still being written.
+  void set_flush_limit(SizeT limit) { flush_limit_ = limit; }
+
+  void clear_flush_limit() {
+    flush_limit_ = (std::numeric_limits<SizeT>::max)();
+  }
+
+  // The number of bytes, counting from the end, written to the sink so far.
+  SizeT flushed() const { return flushed_; }
+
+  // The sizes of the parts written to the sink so far, oldest first.
+  const std::vector<size_t>& flushed_segments() const {
+    return flushed_segments_;
+  }
+
+  // Writes the oldest `limit` bytes to the sink, if not done already. Unless
+  // `limit` is a multiple of the alignment, the data left in memory is no
+  // longer aligned, so this is only meant to be called with an unaligned
+  // `limit` when the buffer is done.
+  void flush(SizeT limit) {
+    FLATBUFFERS_ASSERT(sink_ && limit <= size_);
+    if (limit <= flushed_) return;
+    const size_t len = limit - flushed_;
+    uint8_t* end = buf_ + reserved_;
+    if (!sink_->Write(end - len, len)) sink_failed_ = true;
+    flushed_segments_.push_back(len);
+    // Slide what is left up against the end of the buffer.
+    memmove(cur_ + len, cur_, static_cast<size_t>(end - len - cur_));
+    cur_ += len;
+    flushed_ = limit;
+  }
 
   void push(const uint8_t* bytes, size_t num) {
     if (num > 0) {
@@ -217,6 +281,14 @@ class vector_downward {
     scratch_ += sizeof(T);
   }
 
+  // Grows the scratch part by `len` zeroed bytes, returning where they start.
+  uint8_t* scratch_fill(size_t len) {
+    ensure_space(len);
+    memset(scratch_, 0, len);
+    scratch_ += len;
+    return scratch_ - len;
+  }
+
   // fill() is most frequently called with small byte counts (<= 4),
   // which is why we're using loops rather than calling memset.
   void fill(size_t zero_pad_bytes) {
@@ -249,6 +321,11 @@ class vector_downward {
     swap(buf_, other.buf_);
     swap(cur_, other.cur_);
     swap(scratch_, other.scratch_);
+    swap(sink_, other.sink_);
+    swap(sink_failed_, other.sink_failed_);
+    swap(flushed_, other.flushed_);
+    swap(flush_limit_, other.flush_limit_);
+    swap(flushed_segments_, other.flushed_segments_);
   }
 
   void swap_allocator(vector_downward& other) {
@@ -274,10 +351,22 @@ class vector_downward {
   uint8_t* buf_;
   uint8_t* cur_;  // Points at location between empty (below) and used (above).
   uint8_t* scratch_;  // Points to the end of the scratchpad in use.
+  BufferSink* sink_;
+  bool sink_failed_;
+  SizeT flushed_;  // Bytes no longer in memory, counting from the end.
+  SizeT flush_limit_;
+  std::vector<size_t> flushed_segments_;
 
   void reallocate(size_t len) {
+    if (sink_) {
+      // Make room by flushing before resorting to growing the buffer. Flush a
+      // multiple of the alignment, so what stays in memory stays aligned.
+      const auto limit = (std::min)(flush_limit_, size_);
+      flush(limit & ~static_cast<SizeT>(buffer_minalign_ - 1));
+      if (len <= unused_buffer_size()) return;
+    }
     auto old_reserved = reserved_;
-    auto old_size = size();
+    auto old_size = size() - flushed_;
     auto old_scratch_size = scratch_size();
     reserved_ +=
         (std::max)(len, old_reserved ? old_reserved / 2 : initial_size_);
@@ -18,6 +18,7 @@
 #define FLATBUFFERS_VERIFIER_H_
 
 #include "flatbuffers/base.h"
+#include "flatbuffers/parallel_for.h"
 #include "flatbuffers/vector.h"
 
 namespace flatbuffers {
@@ -39,6 +40,18 @@ class VerifierTemplate FLATBUFFERS_FINAL_CLASS {
     size_t max_size = FLATBUFFERS_MAX_BUFFER_SIZE;
     // Use assertions to check for errors.
     bool assert = false;
+    // If true, verifying a table does not descend into the tables it refers
+    // to (beyond checking that the offsets to them are inside the buffer),
+    // nor into nested flatbuffers. See LazyVerifier.
+    bool shallow = false;
+    // If set, vectors of at least `2 * parallel_min_tables` tables are split
+    // into tasks of `parallel_min_tables` tables each, which are verified by
+    // calling this with `parallel_for_context` and the number of tasks.
+    // Vectors nested in a vector being verified in parallel are verified
+    // serially.
+    ParallelFor parallel_for = nullptr;
+    void* parallel_for_context = nullptr;
+    uoffset_t parallel_min_tables = 1024;
   };
 
   explicit VerifierTemplate(const uint8_t* const buf, const size_t buf_len,
@@ -60,6 +73,28 @@ class VerifierTemplate FLATBUFFERS_FINAL_CLASS {
           return opts;
         }()) {}
 
+  // Verify a single table, but none of the tables it refers to. Only
+  // meaningful with Options::shallow set.
+  template <typename T>
+  bool VerifyShallowTable(const T* const table) {
+    FLATBUFFERS_ASSERT(opts_.shallow);
+    // Each table is verified on its own, so the limits apply per table.
+    depth_ = 0;
+    num_tables_ = 0;
+    return VerifyTable(table);
+  }
+
+  // Points this verifier at another buffer and resets its state, so one
+  // verifier can be reused for many buffers.
+  void Reset(const uint8_t* const buf, const size_t buf_len) {
+    FLATBUFFERS_ASSERT(buf_len < opts_.max_size);
+    buf_ = buf;
+    size_ = buf_len;
+    upper_bound_ = 0;
+    depth_ = 0;
+    num_tables_ = 0;
+  }
+
   // Central location where any verification failures register.
   bool Check(const bool ok) const {
     // clang-format off
@@ -117,7 +152,7 @@ class VerifierTemplate FLATBUFFERS_FINAL_CLASS {
   // Verify a pointer (may be NULL) of a table type.
   template <typename T>
   bool VerifyTable(const T* const table) {
-    return !table || table->Verify(*this);
+    return !table || (opts_.shallow && depth_ > 0) || table->Verify(*this);
   }
 
   // Verify a pointer (may be NULL) of any vector type.
@@ -173,7 +208,11 @@ class VerifierTemplate FLATBUFFERS_FINAL_CLASS {
   // Special case for table contents, after the above has been called.
   template <typename T>
   bool VerifyVectorOfTables(const Vector<Offset<T>>* const vec) {
-    if (vec) {
+    if (vec && !opts_.shallow) {
+      if (opts_.parallel_for && opts_.parallel_min_tables &&
+          vec->size() / 2 >= opts_.parallel_min_tables) {
+        return VerifyVectorOfTablesInParallel(vec);
+      }
       for (uoffset_t i = 0; i < vec->size(); i++) {
         if (!vec->Get(i)->Verify(*this)) return false;
       }
@@ -181,6 +220,73 @@ class VerifierTemplate FLATBUFFERS_FINAL_CLASS {
     return true;
   }
 
+  // Verifies the tables of `vec` in tasks run by Options::parallel_for. Each
+  // task may verify an equal share of the tables left below max_tables, so
+  // together they do no more work than a serial verifier, and only write to
+  // their own slots of `results`. If any task fails, the vector is verified
+  // again serially, so the same check fails as would have without
+  // parallelism.
+  template <typename T>
+  bool VerifyVectorOfTablesInParallel(const Vector<Offset<T>>* const vec) {
+    struct TaskResult {
+      bool ok;
+      uoffset_t num_tables;
+      size_t upper_bound;
+    };
+    struct Tasks {
+      VerifierTemplate* verifier;
+      const Vector<Offset<T>>* vec;
+      Options opts;
+      std::vector<TaskResult> results;
+
+      static void Run(void* tasks, size_t task) {
+        static_cast<Tasks*>(tasks)->Verify(task);
+      }
+
+      void Verify(size_t task) {
+        VerifierTemplate task_verifier(verifier->buf_, verifier->size_, opts);
+        task_verifier.depth_ = verifier->depth_;
+        const uoffset_t task_size = opts.parallel_min_tables;
+        const uoffset_t begin = static_cast<uoffset_t>(task * task_size);
+        const uoffset_t end = (std::min)(vec->size(), begin + task_size);
+        auto& result = results[task];
+        result.ok = true;
+        for (uoffset_t i = begin; result.ok && i < end; i++) {
+          result.ok = vec->Get(i)->Verify(task_verifier);
+        }
+        result.num_tables = task_verifier.num_tables_;
+        result.upper_bound = task_verifier.upper_bound_;
+      }
+    };
+    const uoffset_t size = vec->size();
+    const uoffset_t task_size = opts_.parallel_min_tables;
+    const size_t num_tasks = (size + task_size - 1) / task_size;
+    Tasks tasks;
+    tasks.verifier = this;
+    tasks.vec = vec;
+    tasks.opts = opts_;
+    tasks.opts.parallel_for = nullptr;
+    tasks.opts.assert = false;
+    tasks.opts.max_tables =
+        static_cast<uoffset_t>((opts_.max_tables - num_tables_) / num_tasks);
+    tasks.results.resize(num_tasks);
+    opts_.parallel_for(opts_.parallel_for_context, num_tasks, Tasks::Run,
+                       &tasks);
+    bool ok = true;
+    for (size_t i = 0; i < num_tasks; i++) ok = ok && tasks.results[i].ok;
+    if (!ok) {
+      for (uoffset_t i = 0; i < size; i++) {
+        if (!vec->Get(i)->Verify(*this)) return false;
+      }
+      return true;
+    }
+    for (size_t i = 0; i < num_tasks; i++) {
+      num_tables_ += tasks.results[i].num_tables;
+      upper_bound_ = (std::max)(upper_bound_, tasks.results[i].upper_bound);
+    }
+    return true;
+  }
+
   FLATBUFFERS_SUPPRESS_UBSAN("unsigned-integer-overflow")
   bool VerifyTableStart(const uint8_t* const table) {
     // Check the vtable offset.
@@ -228,7 +334,7 @@ class VerifierTemplate FLATBUFFERS_FINAL_CLASS {
   bool VerifyNestedFlatBuffer(const Vector<uint8_t, SizeT>* const buf,
                               const char* const identifier) {
     // Caller opted out of this.
-    if (!opts_.check_nested_flatbuffers) return true;
+    if (!opts_.check_nested_flatbuffers || opts_.shallow) return true;
 
     // An empty buffer is OK as it indicates not present.
     if (!buf) return true;
@@ -252,6 +358,42 @@ class VerifierTemplate FLATBUFFERS_FINAL_CLASS {
     return VerifyBufferFromStart<T>(identifier, 0);
   }
 
+  // Verify `count` buffers at once, all with root type T, where buffer `i`
+  // starts at `bufs[i]` and is `lens[i]` bytes long. Bit `i % 64` of
+  // `results[i / 64]` is set if buffer `i` is valid, so `results` must have
+  // room for `(count + 63) / 64` words. This verifier is reused for each
+  // buffer, and left pointing at the last one verified.
+  // Returns the number of valid buffers.
+  template <typename T>
+  size_t VerifyBuffers(const uint8_t* const* const bufs,
+                       const size_t* const lens, const size_t count,
+                       const char* const identifier, uint64_t* const results) {
+    // First rule out buffers whose root offset is out of bounds. This loop
+    // does not branch on the buffer contents, so it can be vectorized.
+    for (size_t i = 0; i < (count + 63) / 64; i++) results[i] = 0;
+    for (size_t i = 0; i < count; i++) {
+      const size_t len = lens[i];
+      const bool big_enough = len >= FLATBUFFERS_MIN_BUFFER_SIZE;
+      const size_t root =
+          big_enough ? ReadScalar<uoffset_t>(bufs[i]) : size_t(0);
+      const bool ok = big_enough & (len < opts_.max_size) & (root != 0) &
+                      (root < len - sizeof(soffset_t));
+      results[i / 64] |= static_cast<uint64_t>(ok) << (i % 64);
+    }
+    size_t num_valid = 0;
+    for (size_t i = 0; i < count; i++) {
+      const uint64_t bit = uint64_t(1) << (i % 64);
+      if (!(results[i / 64] & bit)) continue;
+      Reset(bufs[i], lens[i]);
+      if (VerifyBuffer<T>(identifier)) {
+        num_valid++;
+      } else {
+        results[i / 64] &= ~bit;
+      }
+    }
+    return num_valid;
+  }
+
   template <typename T, typename SizeT = uoffset_t>
   bool VerifySizePrefixedBuffer(const char* const identifier) {
     return Verify<SizeT>(0U) &&
@@ -326,7 +468,7 @@ class VerifierTemplate FLATBUFFERS_FINAL_CLASS {
 
  private:
   const uint8_t* buf_;
-  const size_t size_;
+  size_t size_;
   const Options opts_;
 
   mutable size_t upper_bound_ = 0;
@@ -365,6 +507,105 @@ using Verifier = SizeVerifier;
 using Verifier = VerifierTemplate</*TrackVerifierBufferSize = */ false>;
 #endif
 
+/// @brief Verifies a buffer as it is read, one table at a time, rather than
+/// all of it up front. This suits large buffers of which only a few fields are
+/// read. A table obtained from a verified table must be passed through
+/// `Verified()` before its fields are read. Strings, vectors and structs are
+/// verified along with the table that refers to them, except that the tables
+/// in a vector of tables must each go through `Verified()`.
+/// Nested flatbuffers are not verified.
+template <bool TrackVerifierBufferSize>
+class LazyVerifierTemplate FLATBUFFERS_FINAL_CLASS {
+ public:
+  typedef typename VerifierTemplate<TrackVerifierBufferSize>::Options Options;
+
+  // If `memoize` is true, the tables verified so far are remembered, so that
+  // reading a table again (as the same type) does not verify it again. This
+  // takes a bit of memory for every 4 bytes of the buffer, for every table
+  // type read.
+  LazyVerifierTemplate(const uint8_t* const buf, const size_t buf_len,
+                       Options opts = Options(), const bool memoize = true)
+      : verifier_(buf, buf_len, Shallow(opts)),
+        buf_(buf),
+        size_(buf_len),
+        memoize_(memoize) {}
+
+  // Returns the root table of the buffer, or nullptr if the buffer or its root
+  // table is invalid.
+  template <typename T>
+  const T* GetRoot(const char* const identifier = nullptr) {
+    if (!verifier_.Check(size_ >= FLATBUFFERS_MIN_BUFFER_SIZE)) return nullptr;
+    if (identifier && !verifier_.Check(BufferHasIdentifier(buf_, identifier))) {
+      return nullptr;
+    }
+    const auto o = verifier_.template VerifyOffset<uoffset_t>(0);
+    if (!o) return nullptr;
+    return Verified(reinterpret_cast<const T*>(buf_ + o));
+  }
+
+  // Returns `table` if it is valid, or nullptr if it is not (or is nullptr
+  // itself).
+  template <typename T>
+  const T* Verified(const T* const table) {
+    if (!table) return nullptr;
+    const auto offset = reinterpret_cast<const uint8_t*>(table) - buf_;
+    // Tables are aligned as uoffset_t, unless alignment isn't checked.
+    const bool memo =
+        memoize_ && (offset & (sizeof(uoffset_t) - 1)) == 0 && offset >= 0 &&
+        static_cast<size_t>(offset) < size_;
+    const size_t slot = static_cast<size_t>(offset) / sizeof(uoffset_t);
+    // A table that is valid as one type need not be as another, so tables
+    // are remembered per type.
+    std::vector<uint8_t>* verified = nullptr;
+    if (memo) {
+      verified = &VerifiedTables(TypeKey<T>());
+      if ((*verified)[slot / 8] & (1 << (slot % 8))) return table;
+    }
+    if (!verifier_.VerifyShallowTable(table)) return nullptr;
+    if (memo) (*verified)[slot / 8] |= static_cast<uint8_t>(1 << (slot % 8));
+    return table;
+  }
+
+ private:
+  static Options Shallow(Options opts) {
+    opts.shallow = true;
+    return opts;
+  }
+
+  // An address unique to the table type T.
+  template <typename T>
+  static const void* TypeKey() {
+    static const char key = 0;
+    return &key;
+  }
+
+  // The bitmap of the tables verified so far as the type with `type_key`.
+  std::vector<uint8_t>& VerifiedTables(const void* type_key) {
+    if (last_ < verified_.size() && verified_[last_].first == type_key) {
+      return verified_[last_].second;
+    }
+    for (last_ = 0; last_ < verified_.size(); last_++) {
+      if (verified_[last_].first == type_key) return verified_[last_].second;
+    }
+    verified_.push_back(std::make_pair(
+        type_key,
+        std::vector<uint8_t>((size_ / sizeof(uoffset_t) + 7) / 8, 0)));
+    return verified_.back().second;
+  }
+
+  VerifierTemplate<TrackVerifierBufferSize> verifier_;
+  const uint8_t* buf_;
+  size_t size_;
+  bool memoize_;
+  // For every table type read so far, one bit per uoffset_t in the buffer,
+  // set for the tables verified as that type.
+  std::vector<std::pair<const void*, std::vector<uint8_t>>> verified_;
+  // The index in verified_ of the type looked up last.
+  size_t last_ = 0;
+};
+
+using LazyVerifier = LazyVerifierTemplate<false>;
+
 }  // namespace flatbuffers
 
 #endif  // FLATBUFFERS_VERIFIER_H_
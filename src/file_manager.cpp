@@ -16,6 +16,7 @@
 
 #include "flatbuffers/file_manager.h"
 
+#include <cstdio>
 #include <fstream>
 #include <set>
 #include <string>
@@ -30,4 +31,16 @@ bool RealFileSaver::SaveFile(const char* name, const char* buf, size_t len,
   return !ofs.bad();
 }
 
+bool RealFileSaver::SaveFile(const char* name, bool binary,
+                             const Writer& write) {
+  FILE* file = fopen(name, binary ? "wb" : "w");
+  if (!file) return false;
+  FileBufferSink sink(file);
+  const auto ok = write(sink);
+  const auto closed = fclose(file) == 0;
+  // Don't leave a partial file behind.
+  if (!ok) remove(name);
+  return ok && closed;
+}
+
 }  // namespace flatbuffers
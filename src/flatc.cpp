@@ -116,6 +116,9 @@ const static FlatCOption flatc_options[] = {
      "Generate type name functions for C++ and Rust."},
     {"", "gen-object-api", "", "Generate an additional object-based API."},
     {"", "gen-compare", "", "Generate operator== for object-based API types."},
+    {"", "gen-fixed-create", "",
+     "Generate CreateXFixed functions for C++ tables, which write every field "
+     "at an offset precomputed by flatc."},
     {"", "gen-nullable", "",
      "Add Clang _Nullable for C++ pointer. or @Nullable for Java"},
     {"", "java-package-prefix", "",
@@ -534,6 +537,8 @@ FlatCOptions FlatCompiler::ParseFromCommandLineArguments(int argc,
         opts.generate_object_based_api = true;
       } else if (arg == "--gen-compare") {
         opts.gen_compare = true;
+      } else if (arg == "--gen-fixed-create") {
+        opts.gen_fixed_create = true;
       } else if (arg == "--gen-absl-hash") {
         opts.gen_absl_hash = true;
       } else if (arg == "--cpp-include") {
@@ -2609,15 +2609,14 @@ class CppGenerator : public BaseGenerator {
       code_ += "    return strcmp({{FIELD_NAME}}()->c_str(), _{{FIELD_NAME}});";
       code_ += "  }";
       // Compares key against any string-like object (e.g. std::string_view or
-      // std::string) that implements operator< comparison with const char*.
+      // std::string), using its length where it has one.
       code_ += "  template<typename StringType>";
       code_ +=
           "  int KeyCompareWithValue(const StringType& _{{FIELD_NAME}}) const "
           "{";
       code_ +=
-          "    if ({{FIELD_NAME}}()->c_str() < _{{FIELD_NAME}}) return -1;";
-      code_ += "    if (_{{FIELD_NAME}} < {{FIELD_NAME}}()->c_str()) return 1;";
-      code_ += "    return 0;";
+          "    return ::flatbuffers::CompareStringKey(*{{FIELD_NAME}}(), "
+          "_{{FIELD_NAME}});";
     } else if (is_array) {
       const auto& elem_type = field.value.type.VectorType();
       std::string input_type = "::flatbuffers::Array<" +
@@ -3255,6 +3254,126 @@ class CppGenerator : public BaseGenerator {
     return "";
   }
 
+  // Generate a CreateXFixed function, which writes all fields at offsets
+  // worked out here rather than tracking them at runtime, with a vtable that is
+  // precomputed as well.
+  void GenFixedCreate(const StructDef& struct_def) {
+    std::vector<const FieldDef*> fields;
+    for (const auto& field : struct_def.fields.vec) {
+      if (field->deprecated) continue;
+      const auto& type = field->value.type;
+      // Union values may be absent, and 64-bit offsets must be added before
+      // anything else, so neither fits a fixed layout.
+      if (IsUnion(type) || type.base_type == BASE_TYPE_UTYPE ||
+          (IsVector(type) && (IsUnion(type.VectorType()) ||
+                              type.element == BASE_TYPE_UTYPE)) ||
+          field->offset64) {
+        return;
+      }
+      fields.push_back(field);
+    }
+
+    // Place the fields back to back from the end of the table, by decreasing
+    // alignment, so none of them need padding.
+    std::stable_sort(fields.begin(), fields.end(),
+                     [](const FieldDef* a, const FieldDef* b) {
+                       return InlineAlignment(a->value.type) >
+                              InlineAlignment(b->value.type);
+                     });
+    size_t alignment = sizeof(soffset_t);
+    size_t fields_size = 0;
+    std::vector<size_t> field_ends;
+    for (const auto* field : fields) {
+      fields_size += InlineSize(field->value.type);
+      field_ends.push_back(fields_size);
+      alignment = (std::max)(alignment, InlineAlignment(field->value.type));
+    }
+    // The vtable offset comes first, aligned like the rest of the table.
+    const size_t object_size =
+        ((fields_size + sizeof(soffset_t) - 1) & ~(sizeof(soffset_t) - 1)) +
+        sizeof(soffset_t);
+
+    voffset_t vtable_size = FieldIndexToOffset(0);
+    for (const auto* field : fields) {
+      vtable_size = (std::max)(
+          vtable_size,
+          static_cast<voffset_t>(field->value.offset + sizeof(voffset_t)));
+    }
+    std::vector<size_t> vtable(vtable_size / sizeof(voffset_t), 0);
+    vtable[0] = vtable_size;
+    vtable[1] = object_size;
+    std::vector<size_t> field_offsets(fields.size());
+    for (size_t i = 0; i < fields.size(); i++) {
+      field_offsets[i] = object_size - field_ends[i];
+      vtable[fields[i]->value.offset / sizeof(voffset_t)] = field_offsets[i];
+    }
+
+    code_ += "// Writes every field, including those equal to their default.";
+    code_ += "// Offsets must not be null.";
+    code_ +=
+        "inline ::flatbuffers::Offset<{{STRUCT_NAME}}> "
+        "Create{{STRUCT_NAME}}Fixed(";
+    code_ += "    " + GetBuilder() + " &_fbb\\";
+    for (const auto& field : struct_def.fields.vec) {
+      if (field->deprecated) continue;
+      const auto& type = field->value.type;
+      code_.SetValue("PARAM_NAME", Name(*field));
+      if (IsStruct(type)) {
+        code_.SetValue("PARAM_TYPE",
+                       "const " + WrapInNameSpace(*type.struct_def) + " &");
+      } else {
+        code_.SetValue("PARAM_TYPE", GenTypeWire(type, " ", true));
+      }
+      code_ += ",\n    {{PARAM_TYPE}}{{PARAM_NAME}}\\";
+    }
+    code_ += ") {";
+    std::string vtable_init;
+    for (size_t i = 0; i < vtable.size(); i++) {
+      vtable_init += (i ? ", " : "") + NumToString(vtable[i]);
+    }
+    code_ += "  static const ::flatbuffers::voffset_t _vt[] = { " +
+             vtable_init + " };";
+    code_ += "  const auto _start = _fbb.StartFixedTable(" +
+             NumToString(object_size) + ", " + NumToString(alignment) + ");";
+    bool has_inline_fields = false;
+    for (const auto* field : fields) {
+      if (IsScalar(field->value.type.base_type) ||
+          IsStruct(field->value.type)) {
+        has_inline_fields = true;
+      }
+    }
+    if (has_inline_fields) {
+      code_ += "  uint8_t *_buf = _fbb.GetCurrentBufferPointer();";
+    }
+    for (size_t i = 0; i < fields.size(); i++) {
+      const auto& field = *fields[i];
+      const auto& type = field.value.type;
+      code_.SetValue("FIELD_NAME", Name(field));
+      code_.SetValue("FIELD_OFFSET", NumToString(field_offsets[i]));
+      if (IsScalar(type.base_type)) {
+        code_.SetValue("FIELD_TYPE", GenTypeWire(type, "", false));
+        code_.SetValue("FIELD_VALUE", GenUnderlyingCast(field, false,
+                                                        Name(field)));
+        code_ +=
+            "  ::flatbuffers::WriteScalar<{{FIELD_TYPE}}>(_buf + "
+            "{{FIELD_OFFSET}}, {{FIELD_VALUE}});";
+      } else if (IsStruct(type)) {
+        code_.SetValue("FIELD_SIZE", NumToString(InlineSize(type)));
+        code_ +=
+            "  memcpy(_buf + {{FIELD_OFFSET}}, &{{FIELD_NAME}}, "
+            "{{FIELD_SIZE}});";
+      } else {
+        code_ +=
+            "  _fbb.SetFixedOffset(_start, {{FIELD_OFFSET}}, {{FIELD_NAME}});";
+      }
+    }
+    code_ +=
+        "  return ::flatbuffers::Offset<{{STRUCT_NAME}}>("
+        "_fbb.EndFixedTable(_start, _vt));";
+    code_ += "}";
+    code_ += "";
+  }
+
   void GenBuilders(const StructDef& struct_def) {
     code_.SetValue("STRUCT_NAME", Name(struct_def));
 
@@ -3372,6 +3491,8 @@ class CppGenerator : public BaseGenerator {
     code_ += "}";
     code_ += "";
 
+    if (opts_.gen_fixed_create) GenFixedCreate(struct_def);
+
     // Definition for type traits for this table type. This allows querying var-
     // ious compile-time traits of the table.
     if (opts_.g_cpp_std >= cpp::CPP_STD_17) {
@@ -3436,10 +3557,13 @@ class CppGenerator : public BaseGenerator {
           code_ += "  auto {{FIELD_NAME}}__ = {{FIELD_NAME}} ? \\";
           const auto vtype = field->value.type.VectorType();
           const auto has_key = TypeHasKey(vtype);
+          const std::string order =
+              field->attributes.Lookup("eytzinger") ? "Eytzinger" : "Sorted";
           if (IsStruct(vtype)) {
             const std::string type = WrapInNameSpace(*vtype.struct_def);
             if (has_key) {
-              code_ += "_fbb.CreateVectorOfSortedStructs<" + type + ">\\";
+              code_ += "_fbb.CreateVectorOf" + order + "Structs<" + type +
+                       ">\\";
             } else {
               // If the field uses 64-bit addressing, create a 64-bit vector.
               if (field->value.type.base_type == BASE_TYPE_VECTOR64) {
@@ -3456,7 +3580,7 @@ class CppGenerator : public BaseGenerator {
             }
           } else if (has_key) {
             const auto type = WrapInNameSpace(*vtype.struct_def);
-            code_ += "_fbb.CreateVectorOfSortedTables<" + type + ">\\";
+            code_ += "_fbb.CreateVectorOf" + order + "Tables<" + type + ">\\";
           } else {
             const auto type = GenTypeWire(
                 vtype, "", VectorElementUserFacing(vtype), field->offset64);
@@ -3772,6 +3896,7 @@ class CppGenerator : public BaseGenerator {
       case BASE_TYPE_VECTOR64:
       case BASE_TYPE_VECTOR: {
         auto vector_type = field.value.type.VectorType();
+        const bool eytzinger = field.attributes.Lookup("eytzinger") != nullptr;
         switch (vector_type.base_type) {
           case BASE_TYPE_STRING: {
             if (NativeString(&field) == "std::string") {
@@ -3796,7 +3921,18 @@ class CppGenerator : public BaseGenerator {
               const auto& struct_attrs =
                   field.value.type.struct_def->attributes;
               const auto native_type = struct_attrs.Lookup("native_type");
-              if (native_type) {
+              if (native_type && eytzinger) {
+                code += "_fbb.CreateVectorOfEytzingerNativeStructs<";
+                code += WrapInNameSpace(*vector_type.struct_def) + ", " +
+                        native_type->constant + ">";
+                code += "(" + value;
+                const auto pack_name =
+                    struct_attrs.Lookup("native_type_pack_name");
+                if (pack_name) {
+                  code += ", ::flatbuffers::Pack" + pack_name->constant;
+                }
+                code += ")";
+              } else if (native_type) {
                 code += "_fbb.CreateVectorOfNativeStructs<";
                 code += WrapInNameSpace(*vector_type.struct_def) + ", " +
                         native_type->constant + ">";
@@ -3807,6 +3943,8 @@ class CppGenerator : public BaseGenerator {
                   code += ", ::flatbuffers::Pack" + pack_name->constant;
                 }
                 code += ")";
+              } else if (eytzinger) {
+                code += "_fbb.CreateVectorOfEytzingerStructs(" + value + ")";
               } else {
                 // If the field uses 64-bit addressing, create a 64-bit vector.
                 if (field.value.type.base_type == BASE_TYPE_VECTOR64) {
@@ -3821,8 +3959,13 @@ class CppGenerator : public BaseGenerator {
                 code += "(" + value + ")";
               }
             } else {
-              code += "_fbb.CreateVector<::flatbuffers::Offset<";
-              code += WrapInNameSpace(*vector_type.struct_def) + ">> ";
+              if (eytzinger) {
+                code += "_fbb.CreateVectorOfEytzingerTables<";
+                code += WrapInNameSpace(*vector_type.struct_def) + "> ";
+              } else {
+                code += "_fbb.CreateVector<::flatbuffers::Offset<";
+                code += WrapInNameSpace(*vector_type.struct_def) + ">> ";
+              }
               code += "(" + value + ".size(), ";
               code += "[](size_t i, _VectorArgs *__va) { ";
               code += "return Create" + vector_type.struct_def->name;
@@ -121,6 +121,8 @@ struct JsonPrinter {
       }
       AddIndent(elem_indent);
       PrintScalar(c[i], type, elem_indent);
+      auto err = MaybeFlush();
+      if (err) return err;
     }
     AddNewLine();
     AddIndent(indent);
@@ -149,6 +151,7 @@ struct JsonPrinter {
                            : c[i];
       auto err = PrintOffset(ptr, type, elem_indent, prev_val,
                              static_cast<soffset_t>(i));
+      if (!err) err = MaybeFlush();
       if (err) return err;
     }
     AddNewLine();
@@ -363,6 +366,8 @@ struct JsonPrinter {
         } else {
           prev_val = table->GetAddressOf(fd.value.offset);
         }
+        auto err = MaybeFlush();
+        if (err) return err;
       }
     }
     AddNewLine();
@@ -371,13 +376,33 @@ struct JsonPrinter {
     return nullptr;
   }
 
-  JsonPrinter(const Parser& parser, std::string& dest)
-      : opts(parser.opts), text(dest) {
-    text.reserve(1024);  // Reduce amount of inevitable reallocs.
+  // Passes the text so far on to the sink, if there is one and the text has
+  // grown past flush_size. Only called between values, when no text is
+  // pending changes.
+  const char* MaybeFlush() {
+    if (!sink || text.size() < flush_size) return nullptr;
+    return Flush();
+  }
+
+  const char* Flush() {
+    if (!sink || text.empty()) return nullptr;
+    auto ok = sink->Write(reinterpret_cast<const uint8_t*>(text.data()),
+                          text.size());
+    text.clear();
+    return ok ? nullptr : "write to sink failed";
+  }
+
+  JsonPrinter(const Parser& parser, std::string& dest,
+              BufferSink* _sink = nullptr, size_t _flush_size = 0)
+      : opts(parser.opts), text(dest), sink(_sink), flush_size(_flush_size) {
+    // Reduce amount of inevitable reallocs.
+    text.reserve(sink ? flush_size + 1024 : 1024);
   }
 
   const IDLOptions& opts;
   std::string& text;
+  BufferSink* sink;
+  size_t flush_size;
 };
 
 static const char* GenerateTextImpl(const Parser& parser, const Table* table,
@@ -390,6 +415,17 @@ static const char* GenerateTextImpl(const Parser& parser, const Table* table,
   return nullptr;
 }
 
+static const char* GenerateTextImpl(const Parser& parser, const Table* table,
+                                    const StructDef& struct_def,
+                                    BufferSink& sink, size_t buffer_size) {
+  std::string text;
+  JsonPrinter printer(parser, text, &sink, buffer_size);
+  auto err = printer.GenStruct(struct_def, table, 0);
+  if (err) return err;
+  printer.AddNewLine();
+  return printer.Flush();
+}
+
 // Generate a text representation of a flatbuffer in JSON format.
 // Deprecated: please use `GenTextFromTable`
 bool GenerateTextFromTable(const Parser& parser, const void* table,
@@ -424,6 +460,28 @@ const char* GenText(const Parser& parser, const void* flatbuffer,
   return GenerateTextImpl(parser, root, *parser.root_struct_def_, _text);
 }
 
+// Generate a text representation of a flatbuffer in JSON format, in parts.
+const char* GenTextFromTable(const Parser& parser, const void* table,
+                             const std::string& table_name, BufferSink& sink,
+                             size_t buffer_size) {
+  auto struct_def = parser.LookupStruct(table_name);
+  if (struct_def == nullptr) {
+    return "unknown struct";
+  }
+  auto root = static_cast<const Table*>(table);
+  return GenerateTextImpl(parser, root, *struct_def, sink, buffer_size);
+}
+
+// Generate a text representation of a flatbuffer in JSON format, in parts.
+const char* GenText(const Parser& parser, const void* flatbuffer,
+                    BufferSink& sink, size_t buffer_size) {
+  FLATBUFFERS_ASSERT(parser.root_struct_def_);  // call SetRootType()
+  auto root = parser.opts.size_prefixed ? GetSizePrefixedRoot<Table>(flatbuffer)
+                                        : GetRoot<Table>(flatbuffer);
+  return GenerateTextImpl(parser, root, *parser.root_struct_def_, sink,
+                          buffer_size);
+}
+
 static std::string TextFileName(const std::string& path,
                                 const std::string& file_name) {
   return path + file_name + ".json";
@@ -447,13 +505,16 @@ const char* GenTextFile(const Parser& parser, const std::string& path,
                : "SaveFile failed";
   }
   if (!parser.builder_.GetSize() || !parser.root_struct_def_) return nullptr;
-  std::string text;
-  auto err = GenText(parser, parser.builder_.GetBufferPointer(), &text);
+  // Write the text as it is generated, so large buffers don't need all of it
+  // in memory.
+  const char* err = nullptr;
+  auto saved = parser.opts.file_saver->SaveFile(
+      TextFileName(path, file_name).c_str(), false, [&](BufferSink& sink) {
+        err = GenText(parser, parser.builder_.GetBufferPointer(), sink);
+        return err == nullptr;
+      });
   if (err) return err;
-  return parser.opts.file_saver->SaveFile(TextFileName(path, file_name).c_str(),
-                                          text, false)
-             ? nullptr
-             : "SaveFile failed";
+  return saved ? nullptr : "SaveFile failed";
 }
 
 static std::string TextMakeRule(const Parser& parser, const std::string& path,
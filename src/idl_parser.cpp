@@ -27,6 +27,15 @@
 #include "flatbuffers/reflection_generated.h"
 #include "flatbuffers/util.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define FLATBUFFERS_SCAN_SSE2
+#  ifdef _MSC_VER
+#    include <intrin.h>
+#  endif
+#endif
+
 namespace flatbuffers {
 
 // Reflects the version at the compiling time of binary(lib/dll/so).
@@ -139,6 +148,63 @@ CheckedError atot<Offset64<void>>(const char* s, Parser& parser,
   return NoError();
 }
 
+// Values parsed from JSON keep scalars and offsets in binary, see Value.
+template <typename T>
+static void SetBinaryValue(Value& val, T t) {
+  static_assert(sizeof(T) <= sizeof(val.binary), "Unexpected value size");
+  val.binary = 0;
+  memcpy(&val.binary, &t, sizeof(T));
+  val.has_binary = true;
+}
+
+static void SetBinaryOffset(Value& val, uoffset64_t offset) {
+  SetBinaryValue<uint64_t>(val, offset);
+}
+
+// Gets the value of `val`, from its binary form if it has one.
+template <typename T>
+static CheckedError ValueTo(const Value& val, Parser& parser, T* t) {
+  if (!val.has_binary) return atot(val.constant.c_str(), parser, t);
+  memcpy(t, &val.binary, sizeof(T));
+  return NoError();
+}
+
+template <>
+CheckedError ValueTo<Offset<void>>(const Value& val, Parser& parser,
+                                   Offset<void>* t) {
+  if (!val.has_binary) return atot(val.constant.c_str(), parser, t);
+  *t = Offset<void>(static_cast<uoffset_t>(val.binary));
+  return NoError();
+}
+
+template <>
+CheckedError ValueTo<Offset64<void>>(const Value& val, Parser& parser,
+                                     Offset64<void>* t) {
+  if (!val.has_binary) return atot(val.constant.c_str(), parser, t);
+  *t = Offset64<void>(val.binary);
+  return NoError();
+}
+
+// Converts a scalar parsed from JSON to binary.
+static CheckedError ScalarToBinary(Value& val, Parser& parser) {
+  switch (val.type.base_type) {
+    // clang-format off
+    #define FLATBUFFERS_TD(ENUM, IDLTYPE, CTYPE, ...) \
+      case BASE_TYPE_ ## ENUM: { \
+        CTYPE t; \
+        ECHECK(atot(val.constant.c_str(), parser, &t)); \
+        SetBinaryValue(val, t); \
+        break; \
+      }
+    FLATBUFFERS_GEN_TYPES_SCALAR(FLATBUFFERS_TD)
+    #undef FLATBUFFERS_TD
+    // clang-format on
+    default:
+      break;
+  }
+  return NoError();
+}
+
 template <typename T>
 static T* LookupTableByName(const SymbolTable<T>& table,
                             const std::string& name,
@@ -204,6 +270,106 @@ static std::string TokenToString(int t) {
 
 static bool IsIdentifierStart(char c) { return is_alpha(c) || (c == '_'); }
 
+// Scanners for the runs of bytes that make up most of a JSON document:
+// indentation, and the plain characters of string constants. The source is a
+// NUL-terminated string of unknown size, so the vectorized versions load
+// aligned 16 byte blocks: a block holding a byte of the source never crosses
+// into another page, and every scan stops at the terminator. This reads
+// (but never uses) bytes past the terminator, hence no address or thread
+// sanitizing, which would report them as out of bounds or freed.
+#if defined(__clang__) || defined(__GNUC__)
+#  define FLATBUFFERS_SCAN_NO_SANITIZE \
+    __attribute__((no_sanitize_address, no_sanitize_thread))
+#else
+#  define FLATBUFFERS_SCAN_NO_SANITIZE
+#endif
+
+#ifdef FLATBUFFERS_SCAN_SSE2
+static inline unsigned FirstSetBit(unsigned mask) {
+#  ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<unsigned>(index);
+#  else
+  return static_cast<unsigned>(__builtin_ctz(mask));
+#  endif
+}
+#endif
+
+// Returns the first byte at or after `p` that is not a space, tab or carriage
+// return.
+FLATBUFFERS_SCAN_NO_SANITIZE static const char* SkipBlanks(const char* p) {
+#ifdef FLATBUFFERS_SCAN_SSE2
+  const auto misalign = reinterpret_cast<uintptr_t>(p) & 15;
+  auto block = p - misalign;
+  unsigned valid = 0xFFFFu << misalign;
+  for (;;) {
+    const auto v = _mm_load_si128(reinterpret_cast<const __m128i*>(block));
+    const auto blank =
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                                  _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+                     _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')));
+    const unsigned other =
+        ~static_cast<unsigned>(_mm_movemask_epi8(blank)) & valid & 0xFFFFu;
+    if (other) return block + FirstSetBit(other);
+    block += 16;
+    valid = 0xFFFFu;
+  }
+#else
+  while (*p == ' ' || *p == '\t' || *p == '\r') p++;
+  return p;
+#endif
+}
+
+// Returns the first byte at or after `p` that ends a run of plain string
+// characters: the `quote` that closes the string, a backslash, or a control
+// character (including the terminator). Clears `*printable_ascii` if the run
+// has any bytes outside of ' '..'~'.
+FLATBUFFERS_SCAN_NO_SANITIZE static const char* ScanStringRun(
+    const char* p, char quote, bool* printable_ascii) {
+#ifdef FLATBUFFERS_SCAN_SSE2
+  const auto misalign = reinterpret_cast<uintptr_t>(p) & 15;
+  auto block = p - misalign;
+  unsigned valid = 0xFFFFu << misalign;
+  const auto quotes = _mm_set1_epi8(quote);
+  const auto backslashes = _mm_set1_epi8('\\');
+  const auto max_control = _mm_set1_epi8(0x1F);
+  const auto del = _mm_set1_epi8(0x7F);
+  for (;;) {
+    const auto v = _mm_load_si128(reinterpret_cast<const __m128i*>(block));
+    // Unsigned v <= 0x1F, as max(v, 0x1F) == 0x1F.
+    const auto control = _mm_cmpeq_epi8(_mm_max_epu8(v, max_control),
+                                        max_control);
+    const auto ends = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(v, quotes),
+                     _mm_cmpeq_epi8(v, backslashes)),
+        control);
+    const unsigned end = static_cast<unsigned>(_mm_movemask_epi8(ends)) & valid;
+    // Bytes with the high bit set (UTF-8), and DEL.
+    unsigned other = static_cast<unsigned>(_mm_movemask_epi8(v) |
+                                           _mm_movemask_epi8(
+                                               _mm_cmpeq_epi8(v, del))) &
+                     valid;
+    if (end) {
+      const auto index = FirstSetBit(end);
+      if (other & ((1u << index) - 1)) *printable_ascii = false;
+      return block + index;
+    }
+    if (other) *printable_ascii = false;
+    block += 16;
+    valid = 0xFFFFu;
+  }
+#else
+  for (;; p++) {
+    const auto c = static_cast<unsigned char>(*p);
+    if (c == static_cast<unsigned char>(quote) || c == '\\' || c < ' ') {
+      return p;
+    }
+    if (c > '~') *printable_ascii = false;
+  }
+#endif
+}
+
 static bool CompareSerializedScalars(const uint8_t* a, const uint8_t* b,
                                      const FieldDef& key) {
   switch (key.value.type.base_type) {
@@ -271,25 +437,30 @@ static void SwapSerializedTables(Offset<Table>* a, Offset<Table>* b) {
   std::swap(*a, *b);
 }
 
-// See below for why we need our own sort :(
-template <typename T, typename F, typename S>
-static void SimpleQsort(T* begin, T* end, size_t width, F comparator,
-                        S swapper) {
-  if (end - begin <= static_cast<ptrdiff_t>(width)) return;
-  auto l = begin + width;
-  auto r = end;
-  while (l < r) {
-    if (comparator(begin, l)) {
-      r -= width;
-      swapper(l, r);
-    } else {
-      l += width;
-    }
+// Puts the elements of a sorted vector in Eytzinger order. `struct_size` is
+// the size of the structs in the vector, or 0 for a vector of tables.
+static void EytzingerOrderSerialized(VectorOfAny* v, size_t struct_size) {
+  auto data = v->Data();
+  const size_t len = v->size();
+  if (struct_size) {
+    std::vector<uint8_t> sorted(data, data + len * struct_size);
+    ForEachEytzingerIndex(len, [&](size_t i, size_t sorted_i) {
+      memcpy(data + i * struct_size, sorted.data() + sorted_i * struct_size,
+             struct_size);
+    });
+  } else {
+    // Offsets are relative to where they are stored, so keep the tables they
+    // point to.
+    std::vector<const uint8_t*> sorted(len);
+    for (size_t i = 0; i < len; i++) {
+      auto elem = data + i * sizeof(uoffset_t);
+      sorted[i] = elem + ReadScalar<uoffset_t>(elem);
+    }
+    ForEachEytzingerIndex(len, [&](size_t i, size_t sorted_i) {
+      auto elem = data + i * sizeof(uoffset_t);
+      WriteScalar(elem, static_cast<uoffset_t>(sorted[sorted_i] - elem));
+    });
   }
-  l -= width;
-  swapper(begin, l);
-  SimpleQsort(begin, l, width, comparator, swapper);
-  SimpleQsort(r, end, width, comparator, swapper);
 }
 
 template <typename T>
@@ -510,6 +681,7 @@ CheckedError Parser::Next() {
       case ' ':
       case '\r':
       case '\t':
+        cursor_ = SkipBlanks(cursor_);
         break;
       case '\n':
         MarkNewLine();
@@ -533,6 +705,17 @@ CheckedError Parser::Next() {
         int unicode_high_surrogate = -1;
 
         while (*cursor_ != c) {
+          if (unicode_high_surrogate == -1) {
+            // Take plain characters in bulk, leaving the rest to the code
+            // below.
+            const auto run_end =
+                ScanStringRun(cursor_, c, &attr_is_trivial_ascii_string_);
+            if (run_end != cursor_) {
+              attribute_.append(cursor_, run_end);
+              cursor_ = run_end;
+              continue;
+            }
+          }
           if (*cursor_ < ' ' && static_cast<signed char>(*cursor_) >= 0)
             return Error("illegal character in string constant");
           if (*cursor_ == '\\') {
@@ -1286,6 +1469,20 @@ CheckedError Parser::ParseField(StructDef& struct_def) {
         "'native_inline' can only be defined on structs, vector of structs or "
         "vector of tables");
 
+  // Whether the element type has a key is checked once it is defined, in
+  // ParseRoot().
+  if (field->attributes.Lookup("eytzinger") &&
+      (type.base_type != BASE_TYPE_VECTOR ||
+       type.element != BASE_TYPE_STRUCT || field->offset64))
+    return Error(
+        "eytzinger attribute may only apply to a vector of tables or structs");
+  // Other languages would look up keys with a binary search, which finds
+  // nothing in a vector in Eytzinger order.
+  if (field->attributes.Lookup("eytzinger") && !SupportsEytzingerVectors())
+    return Error(
+        "eytzinger attribute is not yet supported in at least one of the "
+        "specified programming languages.");
+
   auto nested = field->attributes.Lookup("nested_flatbuffer");
   if (nested) {
     if (nested->type.base_type != BASE_TYPE_STRING)
@@ -1344,13 +1541,15 @@ CheckedError Parser::ParseField(StructDef& struct_def) {
 }
 
 CheckedError Parser::ParseString(Value& val, bool use_string_pooling) {
-  auto s = attribute_;
-  EXPECT(kTokenStringConstant);
+  // Serialize straight from attribute_ rather than a copy of it, NEXT() will
+  // overwrite it.
+  if (!Is(kTokenStringConstant)) EXPECT(kTokenStringConstant);
   if (use_string_pooling) {
-    val.constant = NumToString(builder_.CreateSharedString(s).o);
+    SetBinaryOffset(val, builder_.CreateSharedString(attribute_).o);
   } else {
-    val.constant = NumToString(builder_.CreateString(s).o);
+    SetBinaryOffset(val, builder_.CreateString(attribute_).o);
   }
+  NEXT();
   return NoError();
 }
 
@@ -1366,7 +1565,8 @@ CheckedError Parser::ParseAnyValue(Value& val, FieldDef* field,
   switch (val.type.base_type) {
     case BASE_TYPE_UNION: {
       FLATBUFFERS_ASSERT(field);
-      std::string constant;
+      bool has_type = false;
+      uint8_t enum_idx = 0;
       Vector<uint8_t>* vector_of_union_types = nullptr;
       // Find corresponding type field we may have already parsed.
       for (auto elem = field_stack_.rbegin() + count;
@@ -1376,23 +1576,24 @@ CheckedError Parser::ParseAnyValue(Value& val, FieldDef* field,
           if (inside_vector) {
             if (IsVector(type) && type.element == BASE_TYPE_UTYPE) {
               // Vector of union type field.
-              uoffset_t offset;
-              ECHECK(atot(elem->first.constant.c_str(), *this, &offset));
+              Offset<void> offset;
+              ECHECK(ValueTo(elem->first, *this, &offset));
               vector_of_union_types = reinterpret_cast<Vector<uint8_t>*>(
                   builder_.GetCurrentBufferPointer() + builder_.GetSize() -
-                  offset);
+                  offset.o);
               break;
             }
           } else {
             if (type.base_type == BASE_TYPE_UTYPE) {
               // Union type field.
-              constant = elem->first.constant;
+              ECHECK(ValueTo(elem->first, *this, &enum_idx));
+              has_type = true;
               break;
             }
           }
         }
       }
-      if (constant.empty() && !inside_vector) {
+      if (!has_type && !inside_vector) {
         // We haven't seen the type field yet. Sadly a lot of JSON writers
         // output these in alphabetical order, meaning it comes after this
         // value. So we scan past the value to find it, then come back here.
@@ -1417,35 +1618,38 @@ CheckedError Parser::ParseAnyValue(Value& val, FieldDef* field,
           ParseDepthGuard depth_guard(this);
           ECHECK(depth_guard.Check());
           Value type_val = type_field->value;
+          type_val.has_binary = false;
           ECHECK(ParseAnyValue(type_val, type_field, 0, nullptr, 0));
-          constant = type_val.constant;
+          ECHECK(ValueTo(type_val, *this, &enum_idx));
+          has_type = true;
           // Got the information we needed, now rewind:
           *static_cast<ParserState*>(this) = backup;
         }
       }
-      if (constant.empty() && !vector_of_union_types) {
+      if (!has_type && !vector_of_union_types) {
         return Error("missing type field for this union value: " + field->name);
       }
-      uint8_t enum_idx;
       if (vector_of_union_types) {
         if (vector_of_union_types->size() <= count)
           return Error(
               "union types vector smaller than union values vector for: " +
               field->name);
         enum_idx = vector_of_union_types->Get(static_cast<uoffset_t>(count));
-      } else {
-        ECHECK(atot(constant.c_str(), *this, &enum_idx));
       }
       auto enum_val = val.type.enum_def->ReverseLookup(enum_idx, true);
       if (!enum_val) return Error("illegal type id for: " + field->name);
       if (enum_val->union_type.base_type == BASE_TYPE_STRUCT) {
-        ECHECK(ParseTable(*enum_val->union_type.struct_def, &val.constant,
-                          nullptr));
-        if (enum_val->union_type.struct_def->fixed) {
+        const auto& union_struct_def = *enum_val->union_type.struct_def;
+        if (union_struct_def.fixed) {
+          ECHECK(ParseTable(union_struct_def, &val.constant, nullptr));
           // All BASE_TYPE_UNION values are offsets, so turn this into one.
-          SerializeStruct(*enum_val->union_type.struct_def, val);
+          SerializeStruct(union_struct_def, val);
           builder_.ClearOffsets();
-          val.constant = NumToString(builder_.GetSize());
+          SetBinaryOffset(val, builder_.GetSize());
+        } else {
+          uoffset_t off;
+          ECHECK(ParseTable(union_struct_def, nullptr, &off));
+          SetBinaryOffset(val, off);
         }
       } else if (IsString(enum_val->union_type)) {
         ECHECK(ParseString(val, field->shared));
@@ -1455,7 +1659,13 @@ CheckedError Parser::ParseAnyValue(Value& val, FieldDef* field,
       break;
     }
     case BASE_TYPE_STRUCT:
-      ECHECK(ParseTable(*val.type.struct_def, &val.constant, nullptr));
+      if (val.type.struct_def->fixed) {
+        ECHECK(ParseTable(*val.type.struct_def, &val.constant, nullptr));
+      } else {
+        uoffset_t off;
+        ECHECK(ParseTable(*val.type.struct_def, nullptr, &off));
+        SetBinaryOffset(val, off);
+      }
       break;
     case BASE_TYPE_STRING: {
       ECHECK(ParseString(val, field->shared));
@@ -1465,7 +1675,7 @@ CheckedError Parser::ParseAnyValue(Value& val, FieldDef* field,
     case BASE_TYPE_VECTOR: {
       uoffset_t off;
       ECHECK(ParseVector(val.type, &off, field, parent_fieldn));
-      val.constant = NumToString(off);
+      SetBinaryOffset(val, off);
       break;
     }
     case BASE_TYPE_ARRAY: {
@@ -1488,6 +1698,10 @@ CheckedError Parser::ParseAnyValue(Value& val, FieldDef* field,
       ECHECK(ParseSingleValue(field ? &field->name : nullptr, val, false));
       break;
   }
+  // Special case 'null' (of optional scalars), since atot can't handle that.
+  if (IsScalar(val.type.base_type) && val.constant != "null") {
+    ECHECK(ScalarToBinary(val, *this));
+  }
   return NoError();
 }
 
@@ -1517,9 +1731,10 @@ CheckedError Parser::ParseTableDelimiters(size_t& fieldn,
   } else {
     EXPECT('{');
   }
+  // Reused for all fields, so only long names need to allocate.
+  std::string name;
   for (;;) {
     if ((!opts.strict_json || !fieldn) && Is(terminator)) break;
-    std::string name;
     if (is_nested_vector) {
       if (fieldn >= struct_def->fields.vec.size()) {
         return Error("too many unnamed fields in nested array");
@@ -1571,6 +1786,7 @@ CheckedError Parser::ParseTable(const StructDef& struct_def, std::string* value,
             ECHECK(Next());  // Ignore this field.
           } else {
             Value val = field->value;
+            val.has_binary = false;
             if (field->flexbuffer) {
               flexbuffers::Builder builder(1024,
                                            flexbuffers::BUILDER_FLAG_SHARE_ALL);
@@ -1580,7 +1796,7 @@ CheckedError Parser::ParseTable(const StructDef& struct_def, std::string* value,
               builder_.ForceVectorAlignment(builder.GetSize(), sizeof(uint8_t),
                                             sizeof(largest_scalar_t));
               auto off = builder_.CreateVector(builder.GetBuffer());
-              val.constant = NumToString(off.o);
+              SetBinaryOffset(val, off.o);
             } else if (field->nested_flatbuffer) {
               ECHECK(
                   ParseNestedFlatbuffer(val, field, fieldn, struct_def_inner));
@@ -1654,19 +1870,20 @@ CheckedError Parser::ParseTable(const StructDef& struct_def, std::string* value,
               builder_.Pad(field->padding); \
               if (struct_def.fixed) { \
                 CTYPE val; \
-                ECHECK(atot(field_value.constant.c_str(), *this, &val)); \
+                ECHECK(ValueTo(field_value, *this, &val)); \
                 builder_.PushElement(val); \
               } else { \
                 if (field->IsScalarOptional()) { \
-                  if (field_value.constant != "null") { \
+                  if (field_value.has_binary || \
+                      field_value.constant != "null") { \
                     CTYPE val; \
-                    ECHECK(atot(field_value.constant.c_str(), *this, &val)); \
+                    ECHECK(ValueTo(field_value, *this, &val)); \
                     builder_.AddElement(field_value.offset, val); \
                   } \
                 } else { \
                   CTYPE val, valdef; \
-                  ECHECK(atot(field_value.constant.c_str(), *this, &val)); \
-                  ECHECK(atot(field->value.constant.c_str(), *this, &valdef)); \
+                  ECHECK(ValueTo(field_value, *this, &val)); \
+                  ECHECK(ValueTo(field->value, *this, &valdef)); \
                   builder_.AddElement(field_value.offset, val, valdef); \
                 } \
               } \
@@ -1682,11 +1899,11 @@ CheckedError Parser::ParseTable(const StructDef& struct_def, std::string* value,
                 /* Special case for fields that use 64-bit addressing */ \
                 if(field->offset64) { \
                   Offset64<void> offset; \
-                  ECHECK(atot(field_value.constant.c_str(), *this, &offset)); \
+                  ECHECK(ValueTo(field_value, *this, &offset)); \
                   builder_.AddOffset(field_value.offset, offset); \
                 } else { \
                   CTYPE val; \
-                  ECHECK(atot(field_value.constant.c_str(), *this, &val)); \
+                  ECHECK(ValueTo(field_value, *this, &val)); \
                   builder_.AddOffset(field_value.offset, val); \
                 } \
               } \
@@ -1799,7 +2016,7 @@ CheckedError Parser::ParseVector(const Type& vector_type, uoffset_t* ovalue,
           if (IsStruct(val.type)) SerializeStruct(*val.type.struct_def, val); \
           else { \
              CTYPE elem; \
-             ECHECK(atot(val.constant.c_str(), *this, &elem)); \
+             ECHECK(ValueTo(val, *this, &elem)); \
              builder_.PushElement(elem); \
           } \
           break;
@@ -1834,7 +2051,7 @@ CheckedError Parser::ParseVector(const Type& vector_type, uoffset_t* ovalue,
     // be used to swap elements.
     // And we can't use C qsort either, since that would force use to use
     // globals, making parsing thread-unsafe.
-    // So for now, we use SimpleQsort above.
+    // So for now, we use SimpleQsort from util.h.
     // TODO: replace with something better, preferably not recursive.
 
     if (type.struct_def->fixed) {
@@ -1876,6 +2093,13 @@ CheckedError Parser::ParseVector(const Type& vector_type, uoffset_t* ovalue,
             SwapSerializedTables);
       }
     }
+    if (field->attributes.Lookup("eytzinger")) {
+      auto v =
+          reinterpret_cast<VectorOfAny*>(builder_.GetCurrentBufferPointer());
+      EytzingerOrderSerialized(v, type.struct_def->fixed
+                                      ? type.struct_def->bytesize
+                                      : 0);
+    }
   }
   return NoError();
 }
@@ -1969,7 +2193,7 @@ CheckedError Parser::ParseNestedFlatbuffer(Value& val, FieldDef* field,
 
     auto off = builder_.CreateVector(nested_parser.builder_.GetBufferPointer(),
                                      nested_parser.builder_.GetSize());
-    val.constant = NumToString(off.o);
+    SetBinaryOffset(val, off.o);
   }
   return NoError();
 }
@@ -2843,6 +3067,11 @@ bool Parser::SupportsUnionUnderlyingType() const {
             IDLOptions::kGDScript)) == 0;
 }
 
+bool Parser::SupportsEytzingerVectors() const {
+  return (opts.lang_to_generate &
+          ~(IDLOptions::kCpp | IDLOptions::kJson | IDLOptions::kBinary)) == 0;
+}
+
 Namespace* Parser::UniqueNamespace(Namespace* ns) {
   for (auto it = namespaces_.begin(); it != namespaces_.end(); ++it) {
     if (ns->components == (*it)->components) {
@@ -3609,6 +3838,39 @@ bool Parser::ParseJson(const char* json, const char* json_filename) {
   return done;
 }
 
+JsonDecoder::JsonDecoder(const uint8_t* bfbs, size_t size,
+                         const IDLOptions& opts)
+    : parser_(opts) {
+  ok_ = parser_.Deserialize(bfbs, size);
+  if (!ok_) parser_.error_ = "invalid binary schema";
+}
+
+JsonDecoder::JsonDecoder(const reflection::Schema* schema,
+                         const IDLOptions& opts)
+    : parser_(opts) {
+  ok_ = parser_.Deserialize(schema);
+  if (!ok_) parser_.error_ = "invalid binary schema";
+}
+
+JsonDecoder::JsonDecoder(Parser& schema) : parser_(schema.opts) {
+  schema.Serialize();
+  ok_ = parser_.Deserialize(schema.builder_.GetBufferPointer(),
+                            schema.builder_.GetSize());
+  if (!ok_) parser_.error_ = "invalid schema";
+}
+
+bool JsonDecoder::Decode(const char* json, FlatBufferBuilder& builder,
+                         const char* json_filename) {
+  if (!ok_) return false;
+  if (parser_.opts.force_defaults) builder.ForceDefaults(true);
+  // Parse into the builder of the caller, keeping the memory of the builder
+  // of the parser for the next document.
+  parser_.builder_.Swap(builder);
+  const auto done = parser_.ParseJson(json, json_filename);
+  parser_.builder_.Swap(builder);
+  return done;
+}
+
 std::ptrdiff_t Parser::BytesConsumed() const {
   return std::distance(source_, prev_cursor_);
 }
@@ -3687,6 +3949,16 @@ CheckedError Parser::ParseRoot(const char* source, const char** include_paths,
     ++it;
   }
 
+  for (auto it = structs_.vec.begin(); it != structs_.vec.end(); ++it) {
+    for (const auto* field : (*it)->fields.vec) {
+      if (field->attributes.Lookup("eytzinger") &&
+          !field->value.type.struct_def->has_key) {
+        return Error("eytzinger attribute requires the elements of " +
+                     field->name + " to have a key");
+      }
+    }
+  }
+
   // This check has to happen here and not earlier, because only now do we
   // know for sure what the type of these are.
   for (auto it = enums_.vec.begin(); it != enums_.vec.end(); ++it) {
@@ -3708,6 +3980,7 @@ CheckedError Parser::ParseRoot(const char* source, const char** include_paths,
 
   auto err = CheckPrivateLeak();
   if (err.Check()) return err;
+  ECHECK(SetBinaryDefaults());
 
   // Parse JSON object only if the scheme has been parsed.
   if (token_ == '{') {
@@ -3716,6 +3989,20 @@ CheckedError Parser::ParseRoot(const char* source, const char** include_paths,
   return NoError();
 }
 
+// Converts the defaults of scalar table fields to binary, once the schema is
+// complete, so parsing tables only reads them.
+CheckedError Parser::SetBinaryDefaults() {
+  for (auto it = structs_.vec.begin(); it != structs_.vec.end(); ++it) {
+    if ((*it)->fixed) continue;
+    for (auto* field : (*it)->fields.vec) {
+      if (!field->IsScalarOptional()) {
+        ECHECK(ScalarToBinary(field->value, *this));
+      }
+    }
+  }
+  return NoError();
+}
+
 CheckedError Parser::CheckPrivateLeak() {
   if (!opts.no_leak_private_annotations) return NoError();
   // Iterate over all structs/tables to validate we arent leaking
@@ -4002,7 +4289,10 @@ SerializeAttributesCommon(const SymbolTable<Value>& attributes,
   for (auto kv = attributes.dict.begin(); kv != attributes.dict.end(); ++kv) {
     auto it = parser.known_attributes_.find(kv->first);
     FLATBUFFERS_ASSERT(it != parser.known_attributes_.end());
-    if (parser.opts.binary_schema_builtins || !it->second) {
+    // `eytzinger` changes the layout of a vector, so readers of the schema
+    // always need to see it.
+    if (parser.opts.binary_schema_builtins || !it->second ||
+        kv->first == "eytzinger") {
       auto key = builder->CreateString(kv->first);
       auto val = builder->CreateString(kv->second->constant);
       attrs.push_back(reflection::CreateKeyValue(*builder, key, val));
@@ -4509,6 +4799,7 @@ bool Parser::Deserialize(const reflection::Schema* schema) {
     }
   }
   advanced_features_ = schema->advanced_features();
+  if (SetBinaryDefaults().Check()) return false;
 
   if (schema->fbs_files())
     for (auto s = schema->fbs_files()->begin(); s != schema->fbs_files()->end();
@@ -16,6 +16,7 @@
 
 #include "flatbuffers/reflection.h"
 
+#include "flatbuffers/flex_flat_util.h"
 #include "flatbuffers/util.h"
 
 // Helper functionality for reflection.
@@ -798,3 +799,574 @@ bool VerifySizePrefixed(const reflection::Schema& schema,
 }
 
 }  // namespace flatbuffers
+
+namespace flexbuffers {
+
+namespace {
+
+using flatbuffers::uoffset_t;
+
+// The elements of any kind of FlexBuffer vector.
+class AnyVector {
+ public:
+  explicit AnyVector(Reference ref)
+      : ref_(ref),
+        vec_(ref.AsVector()),
+        typed_(ref.AsTypedVector()),
+        fixed_(ref.AsFixedTypedVector()) {}
+
+  size_t size() const {
+    if (ref_.IsTypedVector()) return typed_.size();
+    if (ref_.IsFixedTypedVector()) return fixed_.size();
+    return vec_.size();
+  }
+
+  Reference operator[](size_t i) const {
+    if (ref_.IsTypedVector()) return typed_[i];
+    if (ref_.IsFixedTypedVector()) return fixed_[i];
+    return vec_[i];
+  }
+
+ private:
+  Reference ref_;
+  Vector vec_;
+  TypedVector typed_;
+  FixedTypedVector fixed_;
+};
+
+class FlexToFlatConverter {
+ public:
+  FlexToFlatConverter(const reflection::Schema& schema,
+                      flatbuffers::FlatBufferBuilder& fbb, std::string* error)
+      : schema_(schema), fbb_(fbb), error_(error) {}
+
+  uoffset_t Table(const reflection::Object& object, Reference ref) {
+    if (!ref.IsMap()) {
+      Fail("expected a map for table: ", object.name()->c_str());
+      return 0;
+    }
+    auto map = ref.AsMap();
+    auto keys = map.Keys();
+    auto values = map.Values();
+    auto fielddefs = object.fields();
+    for (auto it = fielddefs->begin(); it != fielddefs->end(); ++it) {
+      if ((*it)->required() && map[(*it)->name()->c_str()].IsNull()) {
+        Fail("missing required field: ", (*it)->name()->c_str());
+        return 0;
+      }
+    }
+    // Before we can construct the table, we have to first write the strings,
+    // vectors and tables it refers to, and collect their offsets.
+    const size_t offsets_start = offsets_.size();
+    for (size_t i = 0; i < keys.size(); i++) {
+      auto name = keys[i].AsKey();
+      auto fielddef = fielddefs->LookupByKey(name);
+      if (!fielddef) {
+        Fail("unknown field: ", name);
+        return 0;
+      }
+      auto value = values[i];
+      if (fielddef->deprecated() || value.IsNull()) continue;
+      uoffset_t offset = 0;
+      switch (fielddef->type()->base_type()) {
+        case reflection::String:
+          offset = String(value, name);
+          break;
+        case reflection::Vector:
+          offset = Vector(*fielddef, value);
+          break;
+        case reflection::Obj: {
+          auto& subobjectdef =
+              *schema_.objects()->Get(fielddef->type()->index());
+          if (subobjectdef.is_struct()) continue;
+          offset = Table(subobjectdef, value);
+          break;
+        }
+        case reflection::Union: {
+          const reflection::Object* subobjectdef = nullptr;
+          if (!UnionType(*fielddef, map, &subobjectdef)) return 0;
+          if (!subobjectdef) continue;  // NONE.
+          offset = Table(*subobjectdef, value);
+          break;
+        }
+        case reflection::Vector64:
+          Fail("64-bit vectors are not supported: ", name);
+          return 0;
+        default:  // Scalars.
+          continue;
+      }
+      if (!offset) return 0;
+      offsets_.push_back(std::make_pair(fielddef->offset(), offset));
+    }
+    // Now we can build the actual table from the offsets and the scalars.
+    auto start = fbb_.StartTable();
+    for (size_t i = offsets_start; i < offsets_.size(); i++) {
+      fbb_.AddOffset(offsets_[i].first,
+                     flatbuffers::Offset<void>(offsets_[i].second));
+    }
+    offsets_.resize(offsets_start);
+    for (size_t i = 0; i < keys.size(); i++) {
+      auto& fielddef = *fielddefs->LookupByKey(keys[i].AsKey());
+      auto value = values[i];
+      if (fielddef.deprecated() || value.IsNull()) continue;
+      auto base_type = fielddef.type()->base_type();
+      if (base_type == reflection::Obj) {
+        auto& subobjectdef = *schema_.objects()->Get(fielddef.type()->index());
+        if (!subobjectdef.is_struct()) continue;
+        scratch_.resize(subobjectdef.bytesize());
+        if (!Struct(subobjectdef, value, scratch_.data())) return 0;
+        fbb_.Align(subobjectdef.minalign());
+        fbb_.PushBytes(scratch_.data(), scratch_.size());
+        fbb_.TrackField(fielddef.offset(), fbb_.GetSize());
+      } else if (flatbuffers::IsScalar(base_type)) {
+        uint8_t data[sizeof(uint64_t)];
+        if (!Scalar(*fielddef.type(), base_type, value, data,
+                    fielddef.name()->c_str())) {
+          return 0;
+        }
+        auto size = flatbuffers::GetTypeSize(base_type);
+        // Like the JSON parser, leave out values equal to the default.
+        if (!fielddef.optional()) {
+          uint8_t default_data[sizeof(uint64_t)];
+          if (flatbuffers::IsFloat(base_type)) {
+            flatbuffers::SetAnyValueF(base_type, default_data,
+                                      fielddef.default_real());
+          } else {
+            flatbuffers::SetAnyValueI(base_type, default_data,
+                                      fielddef.default_integer());
+          }
+          if (!memcmp(data, default_data, size)) continue;
+        }
+        fbb_.Align(size);
+        fbb_.PushBytes(data, size);
+        fbb_.TrackField(fielddef.offset(), fbb_.GetSize());
+      }
+    }
+    return fbb_.EndTable(start);
+  }
+
+ private:
+  void Fail(const char* msg, const char* name) {
+    if (error_) *error_ = std::string(msg) + name;
+  }
+
+  uoffset_t String(Reference value, const char* name) {
+    if (!value.IsString() && !value.IsKey()) {
+      Fail("expected a string for field: ", name);
+      return 0;
+    }
+    auto str = value.AsString();
+    return fbb_.CreateString(str.c_str(), str.size()).o;
+  }
+
+  uoffset_t Vector(const reflection::Field& fielddef, Reference value) {
+    auto name = fielddef.name()->c_str();
+    auto element_base_type = fielddef.type()->element();
+    if (value.IsBlob() && (element_base_type == reflection::UByte ||
+                           element_base_type == reflection::Byte)) {
+      auto blob = value.AsBlob();
+      fbb_.StartVector(blob.size(), 1, 1);
+      fbb_.PushBytes(blob.data(), blob.size());
+      return fbb_.EndVector(blob.size());
+    }
+    if (!value.IsAnyVector()) {
+      Fail("expected a vector for field: ", name);
+      return 0;
+    }
+    AnyVector vec(value);
+    auto len = vec.size();
+    switch (element_base_type) {
+      case reflection::Obj: {
+        auto& elemobjectdef = *schema_.objects()->Get(fielddef.type()->index());
+        if (elemobjectdef.is_struct()) {
+          auto size = elemobjectdef.bytesize();
+          scratch_.resize(len * size);
+          for (size_t i = 0; i < len; i++) {
+            if (!Struct(elemobjectdef, vec[i], scratch_.data() + i * size)) {
+              return 0;
+            }
+          }
+          SortStructs(fielddef, elemobjectdef);
+          fbb_.StartVector(len, size, elemobjectdef.minalign());
+          for (size_t i = len; i-- > 0;) {
+            fbb_.PushBytes(scratch_.data() + i * size, size);
+          }
+          return fbb_.EndVector(len);
+        }
+      }
+        FLATBUFFERS_FALLTHROUGH();  // fall thru
+      case reflection::String: {
+        const size_t elements_start = elements_.size();
+        for (size_t i = 0; i < len; i++) {
+          auto offset = element_base_type == reflection::String
+                            ? String(vec[i], name)
+                            : Table(*schema_.objects()->Get(
+                                        fielddef.type()->index()),
+                                    vec[i]);
+          if (!offset) return 0;
+          elements_.push_back(offset);
+        }
+        if (element_base_type == reflection::Obj) {
+          SortTables(fielddef,
+                     *schema_.objects()->Get(fielddef.type()->index()),
+                     elements_start);
+        }
+        fbb_.StartVector(len, sizeof(uoffset_t), sizeof(uoffset_t));
+        for (size_t i = len; i-- > 0;) {
+          fbb_.PushElement(
+              flatbuffers::Offset<void>(elements_[elements_start + i]));
+        }
+        elements_.resize(elements_start);
+        return fbb_.EndVector(len);
+      }
+      case reflection::Union:
+      case reflection::Vector:
+      case reflection::Vector64:
+      case reflection::Array:
+        Fail("unsupported vector element type for field: ", name);
+        return 0;
+      default: {  // Scalars.
+        auto size = flatbuffers::GetTypeSize(element_base_type);
+        fbb_.StartVector(len, size, size);
+        for (size_t i = len; i-- > 0;) {
+          uint8_t data[sizeof(uint64_t)];
+          if (!Scalar(*fielddef.type(), element_base_type, vec[i], data,
+                      name)) {
+            return 0;
+          }
+          fbb_.PushBytes(data, size);
+        }
+        return fbb_.EndVector(len);
+      }
+    }
+  }
+
+  static const reflection::Field* KeyField(
+      const reflection::Object& objectdef) {
+    auto fielddefs = objectdef.fields();
+    for (auto it = fielddefs->begin(); it != fielddefs->end(); ++it) {
+      if (it->key()) return *it;
+    }
+    return nullptr;
+  }
+
+  // Compares the scalar keys at `a` and `b`, either of which may be null for a
+  // table that leaves the key at its default.
+  static bool KeyLess(const uint8_t* a, const uint8_t* b,
+                      const reflection::Field& key) {
+    auto base_type = key.type()->base_type();
+    if (flatbuffers::IsFloat(base_type)) {
+      auto def = key.default_real();
+      auto av = a ? flatbuffers::GetAnyValueF(base_type, a) : def;
+      auto bv = b ? flatbuffers::GetAnyValueF(base_type, b) : def;
+      return av < bv;
+    }
+    if (base_type == reflection::ULong) {
+      auto def = static_cast<uint64_t>(key.default_integer());
+      auto av = a ? flatbuffers::ReadScalar<uint64_t>(a) : def;
+      auto bv = b ? flatbuffers::ReadScalar<uint64_t>(b) : def;
+      return av < bv;
+    }
+    auto def = key.default_integer();
+    auto av = a ? flatbuffers::GetAnyValueI(base_type, a) : def;
+    auto bv = b ? flatbuffers::GetAnyValueI(base_type, b) : def;
+    return av < bv;
+  }
+
+  // Like the JSON parser, sorts the `len` structs in `scratch_` by their key,
+  // if they have one, so the vector can be searched with LookupByKey().
+  void SortStructs(const reflection::Field& fielddef,
+                   const reflection::Object& objectdef) {
+    auto key = KeyField(objectdef);
+    if (!key || !flatbuffers::IsScalar(key->type()->base_type())) return;
+    const size_t size = objectdef.bytesize();
+    const size_t len = scratch_.size() / size;
+    const auto offset = key->offset();
+    flatbuffers::SimpleQsort<uint8_t>(
+        scratch_.data(), scratch_.data() + len * size, size,
+        [&](const uint8_t* a, const uint8_t* b) {
+          return KeyLess(a + offset, b + offset, *key);
+        },
+        [size](uint8_t* a, uint8_t* b) {
+          for (size_t i = 0; i < size; i++) std::swap(a[i], b[i]);
+        });
+    if (!fielddef.attributes() ||
+        !fielddef.attributes()->LookupByKey("eytzinger")) {
+      return;
+    }
+    std::vector<uint8_t> sorted(scratch_);
+    flatbuffers::ForEachEytzingerIndex(len, [&](size_t i, size_t sorted_i) {
+      memcpy(scratch_.data() + i * size, sorted.data() + sorted_i * size, size);
+    });
+  }
+
+  // Like the JSON parser, sorts the tables in `elements_` from `start` on by
+  // their key, if they have one.
+  void SortTables(const reflection::Field& fielddef,
+                  const reflection::Object& objectdef, size_t start) {
+    auto key = KeyField(objectdef);
+    if (!key) return;
+    auto begin = elements_.data() + start;
+    auto end = elements_.data() + elements_.size();
+    // The tables are already in the builder, which counts offsets from the
+    // end of the buffer.
+    auto buf_end = fbb_.GetCurrentBufferPointer() + fbb_.GetSize();
+    const auto offset = key->offset();
+    auto field = [&](const uoffset_t* o) {
+      return reinterpret_cast<const flatbuffers::Table*>(buf_end - *o)
+          ->GetAddressOf(offset);
+    };
+    auto swapper = [](uoffset_t* a, uoffset_t* b) { std::swap(*a, *b); };
+    if (key->type()->base_type() == reflection::String) {
+      flatbuffers::SimpleQsort<uoffset_t>(
+          begin, end, 1,
+          [&](const uoffset_t* _a, const uoffset_t* _b) {
+            auto a = field(_a);
+            auto b = field(_b);
+            // Tables without the key go last.
+            if (!a || !b) return a != nullptr;
+            return *reinterpret_cast<const flatbuffers::String*>(
+                       a + flatbuffers::ReadScalar<uoffset_t>(a)) <
+                   *reinterpret_cast<const flatbuffers::String*>(
+                       b + flatbuffers::ReadScalar<uoffset_t>(b));
+          },
+          swapper);
+    } else {
+      flatbuffers::SimpleQsort<uoffset_t>(
+          begin, end, 1,
+          [&](const uoffset_t* a, const uoffset_t* b) {
+            return KeyLess(field(a), field(b), *key);
+          },
+          swapper);
+    }
+    if (!fielddef.attributes() ||
+        !fielddef.attributes()->LookupByKey("eytzinger")) {
+      return;
+    }
+    std::vector<uoffset_t> sorted(begin, end);
+    flatbuffers::ForEachEytzingerIndex(
+        sorted.size(),
+        [&](size_t i, size_t sorted_i) { begin[i] = sorted[sorted_i]; });
+  }
+
+  // Writes the struct `objectdef` to `data`.
+  bool Struct(const reflection::Object& objectdef, Reference value,
+              uint8_t* data) {
+    if (!value.IsMap()) {
+      Fail("expected a map for struct: ", objectdef.name()->c_str());
+      return false;
+    }
+    auto map = value.AsMap();
+    // Zero the padding.
+    memset(data, 0, objectdef.bytesize());
+    auto fielddefs = objectdef.fields();
+    for (auto it = fielddefs->begin(); it != fielddefs->end(); ++it) {
+      auto& fielddef = **it;
+      auto name = fielddef.name()->c_str();
+      auto field_value = map[name];
+      if (field_value.IsNull()) {
+        Fail("missing struct field: ", name);
+        return false;
+      }
+      auto& type = *fielddef.type();
+      auto field_data = data + fielddef.offset();
+      if (type.base_type() == reflection::Obj) {
+        if (!Struct(*schema_.objects()->Get(type.index()), field_value,
+                    field_data)) {
+          return false;
+        }
+      } else if (type.base_type() == reflection::Array) {
+        if (!field_value.IsAnyVector()) {
+          Fail("expected a vector for field: ", name);
+          return false;
+        }
+        AnyVector vec(field_value);
+        if (vec.size() != type.fixed_length()) {
+          Fail("wrong number of elements for field: ", name);
+          return false;
+        }
+        auto elemobjectdef = type.element() == reflection::Obj
+                                 ? schema_.objects()->Get(type.index())
+                                 : nullptr;
+        auto size = elemobjectdef ? elemobjectdef->bytesize()
+                                  : flatbuffers::GetTypeSize(type.element());
+        for (size_t i = 0; i < vec.size(); i++) {
+          auto elem_data = field_data + i * size;
+          if (elemobjectdef ? !Struct(*elemobjectdef, vec[i], elem_data)
+                            : !Scalar(type, type.element(), vec[i],
+                                      elem_data, name)) {
+            return false;
+          }
+        }
+      } else if (!Scalar(type, type.base_type(), field_value, field_data,
+                         name)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Writes a scalar of `base_type` to `data`. Values of enum types may be
+  // given by name, or as several space separated names for bit flags.
+  bool Scalar(const reflection::Type& type, reflection::BaseType base_type,
+              Reference value, uint8_t* data, const char* name) {
+    if ((value.IsString() || value.IsKey()) && type.index() >= 0 &&
+        flatbuffers::IsInteger(base_type)) {
+      auto enumdef = schema_.enums()->Get(type.index());
+      int64_t val = 0;
+      if (!EnumValue(*enumdef, value.AsString().c_str(), &val)) return false;
+      flatbuffers::SetAnyValueI(base_type, data, val);
+    } else if (flatbuffers::IsFloat(base_type)) {
+      flatbuffers::SetAnyValueF(base_type, data, value.AsDouble());
+    } else if (!IntegerFits(base_type, value, name)) {
+      return false;
+    } else if (base_type == reflection::ULong) {
+      flatbuffers::SetAnyValueI(base_type, data,
+                                static_cast<int64_t>(value.AsUInt64()));
+    } else {
+      flatbuffers::SetAnyValueI(base_type, data, value.AsInt64());
+    }
+    return true;
+  }
+
+  // Like the JSON parser, rejects floats and integers that don't fit
+  // `base_type`.
+  bool IntegerFits(reflection::BaseType base_type, Reference value,
+                   const char* name) {
+    if (value.IsFloat()) {
+      Fail("expected an integer for field: ", name);
+      return false;
+    }
+    switch (base_type) {
+      case reflection::Byte: return IntegerFits<int8_t>(value, name);
+      case reflection::UType:
+      case reflection::UByte: return IntegerFits<uint8_t>(value, name);
+      case reflection::Short: return IntegerFits<int16_t>(value, name);
+      case reflection::UShort: return IntegerFits<uint16_t>(value, name);
+      case reflection::Int: return IntegerFits<int32_t>(value, name);
+      case reflection::UInt: return IntegerFits<uint32_t>(value, name);
+      case reflection::Long: return IntegerFits<int64_t>(value, name);
+      case reflection::ULong: return IntegerFits<uint64_t>(value, name);
+      default: return true;
+    }
+  }
+
+  template <typename T>
+  bool IntegerFits(Reference value, const char* name) {
+    typedef flatbuffers::numeric_limits<T> limits;
+    const auto lowest = static_cast<int64_t>(limits::lowest());
+    const auto max = static_cast<uint64_t>(limits::max());
+    bool fits;
+    if (value.IsUInt()) {
+      fits = value.AsUInt64() <= max;
+    } else {
+      auto i = value.AsInt64();
+      fits = i >= lowest && (i < 0 || static_cast<uint64_t>(i) <= max);
+    }
+    if (!fits) {
+      auto msg = "constant does not fit [" +
+                 flatbuffers::NumToString(limits::lowest()) + "; " +
+                 flatbuffers::NumToString(limits::max()) + "] for field: ";
+      Fail(msg.c_str(), name);
+    }
+    return fits;
+  }
+
+  bool EnumValue(const reflection::Enum& enumdef, const char* names,
+                 int64_t* val) {
+    auto enumvals = enumdef.values();
+    for (auto name = names; *name;) {
+      auto end = name;
+      while (*end && *end != ' ') end++;
+      auto len = static_cast<size_t>(end - name);
+      if (len) {
+        auto it = enumvals->begin();
+        for (; it != enumvals->end(); ++it) {
+          if (it->name()->size() == len &&
+              !memcmp(it->name()->c_str(), name, len)) {
+            break;
+          }
+        }
+        if (it == enumvals->end()) {
+          Fail("unknown enum value: ", names);
+          return false;
+        }
+        *val |= it->value();
+      }
+      name = *end ? end + 1 : end;
+    }
+    return true;
+  }
+
+  // Finds the table type of the union field `fielddef` from the
+  // `<field>_type` key in `map`. Sets `objectdef` to null for NONE.
+  bool UnionType(const reflection::Field& fielddef, const Map& map,
+                 const reflection::Object** objectdef) {
+    auto name = fielddef.name()->c_str();
+    union_type_key_.assign(name);
+    union_type_key_.append(flatbuffers::UnionTypeFieldSuffix());
+    auto type_value = map[union_type_key_.c_str()];
+    if (type_value.IsNull()) {
+      Fail("missing union type for field: ", name);
+      return false;
+    }
+    uint8_t union_type = 0;
+    if (!Scalar(*fielddef.type(), reflection::UType, type_value, &union_type,
+                union_type_key_.c_str())) {
+      return false;
+    }
+    *objectdef = nullptr;
+    if (!union_type) return true;
+    auto enumdef = schema_.enums()->Get(fielddef.type()->index());
+    auto enumval = enumdef->values()->LookupByKey(union_type);
+    if (!enumval || !enumval->union_type() ||
+        enumval->union_type()->base_type() != reflection::Obj) {
+      Fail("unsupported union type for field: ", name);
+      return false;
+    }
+    *objectdef = schema_.objects()->Get(enumval->union_type()->index());
+    if ((*objectdef)->is_struct()) {
+      Fail("unsupported union type for field: ", name);
+      return false;
+    }
+    return true;
+  }
+
+  const reflection::Schema& schema_;
+  flatbuffers::FlatBufferBuilder& fbb_;
+  std::string* error_;
+  // Offsets of the fields of the tables being written, and of the elements of
+  // the vectors being written. Shared by nested tables and vectors, which
+  // each use the part from where they started.
+  std::vector<std::pair<flatbuffers::voffset_t, uoffset_t>> offsets_;
+  std::vector<uoffset_t> elements_;
+  std::vector<uint8_t> scratch_;
+  std::string union_type_key_;
+};
+
+}  // namespace
+
+uoffset_t FlexToFlatTable(const reflection::Schema& schema,
+                          const reflection::Object& object, Reference map,
+                          flatbuffers::FlatBufferBuilder& fbb,
+                          std::string* error) {
+  FlexToFlatConverter converter(schema, fbb, error);
+  return converter.Table(object, map);
+}
+
+bool FlexToFlatBuffer(const reflection::Schema& schema, Reference root,
+                      flatbuffers::FlatBufferBuilder& fbb,
+                      std::string* error) {
+  if (!schema.root_table()) {
+    if (error) *error = "schema has no root table";
+    return false;
+  }
+  auto offset = FlexToFlatTable(schema, *schema.root_table(), root, fbb, error);
+  if (!offset) return false;
+  auto file_ident = schema.file_ident();
+  fbb.Finish(flatbuffers::Offset<flatbuffers::Table>(offset),
+             file_ident && file_ident->size() ? file_ident->c_str() : nullptr);
+  return true;
+}
+
+}  // namespace flexbuffers
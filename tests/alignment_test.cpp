@@ -76,5 +76,91 @@ void AlignmentTest() {
   }
 }
 
+void FixedCreateAlignmentTest() {
+  FlatBufferBuilder builder;
+  // Throw off the alignment of what comes next.
+  builder.CreateString("x");
+
+  BadAlignmentLarge large(0x0123456789ABCDEFull);
+  Offset<OuterLarge> outer_large = CreateOuterLargeFixed(builder, large);
+  Offset<OuterLarge> outer_large2 = CreateOuterLargeFixed(builder, large);
+  // The second table reuses the vtable of the first.
+  auto vtable_of = [&](Offset<OuterLarge> table) {
+    auto p = reinterpret_cast<const uint8_t*>(
+        GetTemporaryPointer(builder, table));
+    return p - ReadScalar<soffset_t>(p);
+  };
+  TEST_EQ(vtable_of(outer_large), vtable_of(outer_large2));
+
+  std::vector<BadAlignmentSmall> small_vector = {{1, 2, 3}, {4, 5, 6}};
+  Offset<Vector<const BadAlignmentSmall*>> small_offset =
+      builder.CreateVectorOfStructs(small_vector);
+  Offset<BadAlignmentRoot> root =
+      CreateBadAlignmentRootFixed(builder, outer_large, small_offset);
+  // Fixed and regular tables can be mixed freely.
+  CreateBadAlignmentRoot(builder, outer_large2, small_offset);
+  builder.Finish(root);
+
+  Verifier verifier(builder.GetBufferPointer(), builder.GetSize());
+  TEST_ASSERT(verifier.VerifyBuffer<BadAlignmentRoot>(nullptr));
+
+  auto root_msg =
+      flatbuffers::GetRoot<BadAlignmentRoot>(builder.GetBufferPointer());
+  TEST_EQ(root_msg->large()->large()->var_0(), 0x0123456789ABCDEFull);
+  TEST_EQ(root_msg->small()->size(), 2u);
+  TEST_EQ(root_msg->small()->Get(1)->var_2(), 6u);
+}
+
+void FixedCreateMixedFieldsTest() {
+  const BadAlignmentLarge large(0x0123456789ABCDEFull);
+  const BadAlignmentSmall small(1, 2, 3);
+  // Both the defaults and non-default values must read back the same.
+  for (int defaults = 0; defaults < 2; defaults++) {
+    FlatBufferBuilder builder;
+    builder.CreateString("x");
+    auto name = builder.CreateString("mixed");
+    auto tags = builder.CreateVectorOfStrings({ "a", "bc" });
+    const bool flag = !defaults;
+    const int8_t tiny = defaults ? -3 : 100;
+    const double ratio = defaults ? 0.5 : -1.25;
+    const uint16_t count = defaults ? 7 : 0xFFFF;
+    const bool other_flag = !!defaults;
+    const int64_t id = defaults ? 0 : -0x123456789LL;
+    auto fixed = CreateMixedFieldsFixed(builder, flag, tiny, name, large, ratio,
+                                        count, small, other_flag, id, tags);
+    auto regular = CreateMixedFields(builder, flag, tiny, name, &large, ratio,
+                                     count, &small, other_flag, id, tags);
+    builder.Finish(fixed);
+    Verifier verifier(builder.GetBufferPointer(), builder.GetSize());
+    TEST_ASSERT(verifier.VerifyBuffer<MixedFields>(nullptr));
+
+    auto a = GetTemporaryPointer(builder, fixed);
+    auto b = GetTemporaryPointer(builder, regular);
+    TEST_EQ(a->flag(), b->flag());
+    TEST_EQ(a->tiny(), b->tiny());
+    TEST_EQ_STR(a->name()->c_str(), b->name()->c_str());
+    TEST_EQ(a->large()->var_0(), b->large()->var_0());
+    TEST_EQ(a->ratio(), b->ratio());
+    TEST_EQ(a->count(), b->count());
+    TEST_EQ(a->small()->var_0(), b->small()->var_0());
+    TEST_EQ(a->small()->var_1(), b->small()->var_1());
+    TEST_EQ(a->small()->var_2(), b->small()->var_2());
+    TEST_EQ(a->other_flag(), b->other_flag());
+    TEST_EQ(a->id(), b->id());
+    TEST_EQ(a->tags()->size(), b->tags()->size());
+    for (uoffset_t i = 0; i < a->tags()->size(); i++) {
+      TEST_EQ_STR(a->tags()->Get(i)->c_str(), b->tags()->Get(i)->c_str());
+    }
+    // And they match what was written.
+    TEST_EQ(a->flag(), flag);
+    TEST_EQ(a->tiny(), tiny);
+    TEST_EQ(a->ratio(), ratio);
+    TEST_EQ(a->count(), count);
+    TEST_EQ(a->other_flag(), other_flag);
+    TEST_EQ(a->id(), id);
+    TEST_EQ(a->large()->var_0(), 0x0123456789ABCDEFull);
+  }
+}
+
 }  // namespace tests
 }  // namespace flatbuffers
@@ -5,6 +5,8 @@ namespace flatbuffers {
 namespace tests {
 
 void AlignmentTest();
+void FixedCreateAlignmentTest();
+void FixedCreateMixedFieldsTest();
 
 }  // namespace tests
 }  // namespace flatbuffers
@@ -6,6 +6,7 @@
 #include "flatbuffers/idl.h"
 #include "is_quiet_nan.h"
 #include "test_assert.h"
+#include "test_parallel_for.h"
 
 namespace flatbuffers {
 namespace tests {
@@ -170,6 +171,426 @@ void FlexBuffersReuseBugTest() {
           true);
 }
 
+void FlexBuffersSharedKeyVectorsTest() {
+  auto build = [](flexbuffers::Builder& fbb) {
+    fbb.Vector([&]() {
+      for (int i = 0; i < 10; i++) {
+        fbb.Map([&]() {
+          // Half of the maps have their keys out of order.
+          if (i & 1) {
+            fbb.Int("c", i);
+            fbb.Int("a", i);
+            fbb.Int("b", i);
+          } else {
+            fbb.Int("a", i);
+            fbb.Int("b", i);
+            fbb.Int("c", i);
+          }
+        });
+      }
+      fbb.Map([&]() {
+        fbb.Int("a", 100);
+        fbb.Int("d", 101);
+      });
+    });
+    fbb.Finish();
+  };
+  flexbuffers::Builder shared(512, flexbuffers::BUILDER_FLAG_SHARE_ALL);
+  flexbuffers::Builder unshared(512, flexbuffers::BUILDER_FLAG_SHARE_KEYS);
+  build(shared);
+  build(unshared);
+  // The ten maps with keys a, b and c share a single key vector.
+  TEST_ASSERT(shared.GetSize() < unshared.GetSize());
+  TEST_EQ(shared.HasDuplicateKeys(), false);
+
+  auto& buf = shared.GetBuffer();
+  TEST_EQ(flexbuffers::VerifyBuffer(buf.data(), buf.size()), true);
+  auto vec = flexbuffers::GetRoot(buf).AsVector();
+  TEST_EQ(vec.size(), 11);
+  for (size_t i = 0; i < 10; i++) {
+    auto map = vec[i].AsMap();
+    TEST_EQ(map.size(), 3);
+    TEST_EQ(map["a"].AsInt32(), static_cast<int32_t>(i));
+    TEST_EQ(map["b"].AsInt32(), static_cast<int32_t>(i));
+    TEST_EQ(map["c"].AsInt32(), static_cast<int32_t>(i));
+    TEST_EQ_STR(map.Keys()[0].AsKey(), "a");
+    TEST_EQ_STR(map.Keys()[2].AsKey(), "c");
+  }
+  auto last = vec[10].AsMap();
+  TEST_EQ(last["a"].AsInt32(), 100);
+  TEST_EQ(last["d"].AsInt32(), 101);
+
+  // Duplicate keys are still found when no sorting is needed.
+  flexbuffers::Builder dup(512, flexbuffers::BUILDER_FLAG_SHARE_ALL);
+  dup.Map([&]() {
+    dup.Int("a", 1);
+    dup.Int("a", 2);
+  });
+  dup.Finish();
+  TEST_EQ(dup.HasDuplicateKeys(), true);
+}
+
+void FlexBuffersMapKeyTest() {
+  flexbuffers::Builder fbb(512, flexbuffers::BUILDER_FLAG_SHARE_ALL);
+  fbb.Vector([&]() {
+    for (int i = 0; i < 3; i++) {
+      fbb.Map([&]() {
+        fbb.Int("apple", i);
+        fbb.Int("banana", i + 10);
+        fbb.Int("cherry", i + 20);
+      });
+    }
+    fbb.Map([&]() {
+      fbb.Int("banana", 100);
+      fbb.Int("cherry", 200);
+    });
+  });
+  fbb.Finish();
+  auto vec = flexbuffers::GetRoot(fbb.GetBuffer()).AsVector();
+
+  flexbuffers::MapKey banana("banana");
+  flexbuffers::MapKey cherry("cherry_pie", 6);
+  flexbuffers::MapKey apple("apple");
+  flexbuffers::MapKey app("app");
+  flexbuffers::MapKey apples("apples");
+  for (size_t i = 0; i < 3; i++) {
+    auto map = vec[i].AsMap();
+    TEST_EQ(map[banana].AsInt32(), static_cast<int32_t>(i + 10));
+    TEST_EQ(map[cherry].AsInt32(), static_cast<int32_t>(i + 20));
+    TEST_EQ(map[apple].AsInt32(), static_cast<int32_t>(i));
+    TEST_ASSERT(map[app].IsNull());
+    TEST_ASSERT(map[apples].IsNull());
+  }
+  // A map with other keys must not use what was found in the others.
+  auto other = vec[3].AsMap();
+  TEST_EQ(other[banana].AsInt32(), 100);
+  TEST_EQ(other[cherry].AsInt32(), 200);
+  TEST_ASSERT(other[apple].IsNull());
+  TEST_EQ(vec[0].AsMap()[cherry].AsInt32(), 20);
+  TEST_ASSERT(flexbuffers::Map::EmptyMap()[banana].IsNull());
+}
+
+void FlexBuffersStreamingBuilderTest() {
+  std::vector<uint8_t> out;
+  flatbuffers::CallbackBufferSink sink([&](const uint8_t* data, size_t len) {
+    // The buffer holds at most 16 bytes at a time.
+    TEST_ASSERT(len <= 16);
+    out.insert(out.end(), data, data + len);
+    return true;
+  });
+  const size_t count = 1000;
+
+  // A typed vector comes out the same as from Builder.
+  flexbuffers::StreamingBuilder ints(&sink, 16);
+  ints.StartVector(flexbuffers::FBT_INT, flexbuffers::BIT_WIDTH_16, count);
+  for (size_t i = 0; i < count; i++) ints.Int(static_cast<int64_t>(i) - 500);
+  TEST_EQ(ints.Finish(), true);
+  TEST_EQ(ints.GetSize(), out.size());
+  flexbuffers::Builder fbb;
+  fbb.TypedVector([&]() {
+    for (size_t i = 0; i < count; i++) fbb.Int(static_cast<int64_t>(i) - 500);
+  });
+  fbb.Finish();
+  TEST_ASSERT(out == fbb.GetBuffer());
+
+  out.clear();
+  flexbuffers::StreamingBuilder doubles(&sink, 16);
+  doubles.StartVector(flexbuffers::FBT_FLOAT, flexbuffers::BIT_WIDTH_64, 3);
+  doubles.Double(0.1);
+  doubles.Double(-2.0);
+  doubles.Double(1e300);
+  TEST_EQ(doubles.Finish(), true);
+  fbb.Clear();
+  fbb.TypedVector([&]() {
+    fbb.Double(0.1);
+    fbb.Double(-2.0);
+    fbb.Double(1e300);
+  });
+  fbb.Finish();
+  TEST_ASSERT(out == fbb.GetBuffer());
+
+  // So does a map, if all keys are as long as the longest.
+  out.clear();
+  char key[8];
+  flexbuffers::StreamingBuilder map(&sink, 16);
+  map.StartMap(flexbuffers::FBT_UINT, flexbuffers::BIT_WIDTH_8, count, 4);
+  for (size_t i = 0; i < count; i++) {
+    snprintf(key, sizeof(key), "k%03d", static_cast<int>(i));
+    map.Key(key);
+  }
+  for (size_t i = 0; i < count; i++) map.UInt(i % 200);
+  TEST_EQ(map.Finish(), true);
+  fbb.Clear();
+  fbb.Map([&]() {
+    for (size_t i = 0; i < count; i++) {
+      snprintf(key, sizeof(key), "k%03d", static_cast<int>(i));
+      fbb.UInt(key, i % 200);
+    }
+  });
+  fbb.Finish();
+  TEST_ASSERT(out == fbb.GetBuffer());
+
+  // Shorter keys are padded.
+  out.clear();
+  flexbuffers::StreamingBuilder padded(&sink, 16);
+  padded.StartMap(flexbuffers::FBT_BOOL, flexbuffers::BIT_WIDTH_8, 3, 10);
+  padded.Key("a");
+  padded.Key("bb");
+  padded.Key("c");
+  padded.Bool(true);
+  padded.Bool(false);
+  padded.Bool(true);
+  TEST_EQ(padded.Finish(), true);
+  TEST_EQ(flexbuffers::VerifyBuffer(out.data(), out.size()), true);
+  auto root = flexbuffers::GetRoot(out).AsMap();
+  TEST_EQ(root.size(), 3);
+  TEST_EQ(root["a"].AsBool(), true);
+  TEST_EQ(root["bb"].AsBool(), false);
+  TEST_EQ(root["c"].AsBool(), true);
+  TEST_EQ_STR(root.Keys()[1].AsKey(), "bb");
+}
+
+void FlexBuffersCopyToTest() {
+  const int64_t ints[] = {-1, 2, -300, 40000, -5000000000LL};
+  const double doubles[] = {0.5, -2.25, 1e10};
+  const float floats[] = {1.5f, -3.0f, 4.75f};
+  const int32_t fixed[] = {7, -8, 9};
+  flexbuffers::Builder fbb;
+  fbb.Vector([&]() {
+    // Each prefix of `ints` gives a different byte width.
+    for (size_t n = 2; n <= 5; n++) {
+      fbb.TypedVector([&]() {
+        for (size_t i = 0; i < n; i++) fbb.Int(ints[i]);
+      });
+    }
+    fbb.TypedVector([&]() {
+      for (size_t i = 0; i < 3; i++) fbb.UInt(static_cast<uint64_t>(i) * 100);
+    });
+    fbb.TypedVector([&]() {
+      for (size_t i = 0; i < 3; i++) fbb.Double(doubles[i]);
+    });
+    fbb.TypedVector([&]() {
+      for (size_t i = 0; i < 3; i++) fbb.Float(floats[i]);
+    });
+    fbb.FixedTypedVector(fixed, 3);
+    fbb.TypedVector([&]() { fbb.Key("key"); });
+    fbb.TypedVector([&]() {
+      fbb.Double(3e9);
+      fbb.Double(-3e9);
+    });
+  });
+  fbb.Finish();
+  auto vec = flexbuffers::GetRoot(fbb.GetBuffer()).AsVector();
+
+  for (size_t v = 0; v < 4; v++) {
+    auto typed = vec[v].AsTypedVector();
+    int64_t i64[8];
+    double f64[8];
+    int16_t i16[8];
+    TEST_EQ(typed.CopyTo(i64, 8), typed.size());
+    TEST_EQ(typed.CopyTo(f64, 8), typed.size());
+    TEST_EQ(typed.CopyTo(i16, 1), 1);
+    for (size_t i = 0; i < typed.size(); i++) {
+      TEST_EQ(i64[i], ints[i]);
+      TEST_EQ(i64[i], typed[i].AsInt64());
+      TEST_EQ(f64[i], typed[i].AsDouble());
+    }
+    TEST_EQ(i16[0], -1);
+  }
+  uint32_t u32[3];
+  TEST_EQ(vec[4].AsTypedVector().CopyTo(u32, 3), 3);
+  TEST_EQ(u32[2], 200);
+  double f64[3];
+  float f32[3];
+  int64_t i64[3];
+  TEST_EQ(vec[5].AsTypedVector().CopyTo(f64, 3), 3);
+  TEST_EQ(f64[2], 1e10);
+  TEST_EQ(vec[6].AsTypedVector().CopyTo(f32, 3), 3);
+  TEST_EQ(f32[2], 4.75f);
+  TEST_EQ(vec[6].AsTypedVector().CopyTo(i64, 3), 3);
+  TEST_EQ(i64[1], -3);
+  TEST_EQ(vec[7].AsFixedTypedVector().CopyTo(i64, 3), 3);
+  TEST_EQ(i64[1], -8);
+  TEST_EQ(vec[7].AsFixedTypedVector().CopyTo(f64, 2), 2);
+  TEST_EQ(f64[1], -8.0);
+  // Keys aren't numbers.
+  TEST_EQ(vec[8].AsTypedVector().CopyTo(i64, 3), 0);
+  // Floats that don't fit a narrow integer convert like AsInt32() does.
+  auto big = vec[9].AsTypedVector();
+  int32_t i32[2];
+  TEST_EQ(big.CopyTo(i32, 2), 2);
+  TEST_EQ(i32[0], big[0].AsInt32());
+  TEST_EQ(i32[1], big[1].AsInt32());
+}
+
+void FlexBuffersVerifierReuseTest() {
+  flexbuffers::Builder fbb(512, flexbuffers::BUILDER_FLAG_SHARE_ALL);
+  fbb.Vector([&]() {
+    for (int i = 0; i < 1000; i++) {
+      fbb.Map([&]() {
+        fbb.Int("id", i);
+        fbb.String("name", "shared");
+        fbb.Vector("tags", [&]() { fbb.String("tag"); });
+      });
+    }
+  });
+  fbb.Finish();
+  auto good = fbb.GetBuffer();
+  // Point the root at something that isn't a vector.
+  auto bad = good;
+  bad[bad.size() - 2] = flexbuffers::PackedType(flexbuffers::BIT_WIDTH_8,
+                                                flexbuffers::FBT_MAP);
+
+  // The same tracker can be used for any number of buffers, of any size.
+  flexbuffers::VerifierReuseTracker tracker;
+  for (int i = 0; i < 3; i++) {
+    TEST_EQ(flexbuffers::VerifyBuffer(good.data(), good.size(), tracker), true);
+    TEST_EQ(flexbuffers::VerifyBuffer(bad.data(), bad.size(), tracker), false);
+  }
+
+  flatbuffers::tests::ThreadedParallelFor threads;
+  auto parallel_for = flatbuffers::tests::ThreadedParallelFor::Run;
+  {
+    flexbuffers::Verifier verifier(good.data(), good.size(), tracker);
+    verifier.SetParallelFor(parallel_for, &threads, 100);
+    TEST_EQ(verifier.VerifyBuffer(), true);
+    TEST_EQ(threads.num_tasks(), 10u);
+  }
+  {
+    flexbuffers::Verifier verifier(bad.data(), bad.size());
+    verifier.SetParallelFor(parallel_for, &threads, 100);
+    TEST_EQ(verifier.VerifyBuffer(), false);
+  }
+  {
+    // Vectors nested in the ones verified in parallel are not split further.
+    flatbuffers::tests::ThreadedParallelFor counted_threads;
+    flexbuffers::Verifier verifier(good.data(), good.size());
+    verifier.SetParallelFor(parallel_for, &counted_threads, 1);
+    TEST_EQ(verifier.VerifyBuffer(), true);
+    TEST_EQ(counted_threads.num_tasks(), 1000u);
+  }
+  {
+    // Point one element far outside the buffer, so its task fails and the
+    // vector is verified again serially.
+    auto broken = good;
+    const uint8_t root_width = broken.back();
+    uint8_t* root = broken.data() + broken.size() - 2 - root_width;
+    const size_t elem_width = size_t(1) << (broken[broken.size() - 2] & 3);
+    uint8_t* elems = root - flexbuffers::ReadUInt64(root, root_width);
+    uint8_t* elem = elems + 567 * elem_width;
+    const uint8_t map_width = static_cast<uint8_t>(
+        1 << (elems[1000 * elem_width + 567] & 3));
+    flexbuffers::Map map(elem - flexbuffers::ReadUInt64(elem, elem_width),
+                         map_width);
+    TEST_EQ(map["id"].AsInt32(), 567);
+    memset(elem, 0xFF, elem_width);
+    flexbuffers::Verifier verifier(broken.data(), broken.size());
+    verifier.SetParallelFor(parallel_for, &threads, 100);
+    TEST_EQ(verifier.VerifyBuffer(), false);
+  }
+}
+
+void FlexBuffersEditableTest() {
+  flexbuffers::Builder fbb;
+  fbb.Map([&]() {
+    fbb.String("name", "abc");
+    fbb.Int("count", 1);
+    fbb.Vector("values", [&]() {
+      fbb.Int(1);
+      fbb.Int(2);
+    });
+  });
+  fbb.Finish();
+  auto& doc = fbb.GetBuffer();
+
+  flexbuffers::EditableFlexBuffer edit(doc.data(), doc.size(), 64);
+  auto map = edit.GetRoot().AsMap();
+  // This fits in place.
+  TEST_EQ(edit.SetInt(map, "count", -2), true);
+  TEST_EQ(edit.slack(), 64u);
+  // Strings of the document may be shared, so even one of the same length
+  // goes to the slack region.
+  TEST_EQ(edit.SetString(map, "name", "xyz"), true);
+  auto slack = edit.slack();
+  TEST_ASSERT(slack < 64u);
+  // But one that was written there can be edited in place.
+  map = edit.GetRoot().AsMap();
+  TEST_EQ(edit.SetString(map, "name", "uvw"), true);
+  TEST_EQ(edit.slack(), slack);
+  TEST_EQ_STR(edit.GetRoot().AsMap()["name"].AsString().c_str(), "uvw");
+  // These don't fit, and go to the slack region.
+  TEST_EQ(edit.SetString(map, "name", "a longer name"), true);
+  TEST_EQ(edit.SetInt(map, "count", 1000000), true);
+  auto values = edit.GetRoot().AsMap()["values"].AsVector();
+  TEST_EQ(edit.SetDouble(values, 1, 0.5), true);
+  TEST_EQ(edit.SetBool(values, 0, true), true);
+  TEST_EQ(edit.SetInt(map, "missing", 1), false);
+  TEST_EQ(edit.SetInt(values, 2, 1), false);
+  TEST_ASSERT(edit.slack() < 64u);
+
+  auto check = [&]() {
+    TEST_EQ(flexbuffers::VerifyBuffer(edit.data(), edit.size()), true);
+    auto root = edit.GetRoot().AsMap();
+    TEST_EQ_STR(root["name"].AsString().c_str(), "a longer name");
+    TEST_EQ(root["count"].AsInt64(), 1000000);
+    TEST_EQ(root["values"].AsVector()[0].AsBool(), true);
+    TEST_EQ(root["values"].AsVector()[1].AsDouble(), 0.5);
+  };
+  check();
+
+  // Fill up the slack region.
+  map = edit.GetRoot().AsMap();
+  std::string big(100, 'x');
+  TEST_EQ(edit.SetString(map, "name", big.c_str()), false);
+  check();
+
+  auto size = edit.size();
+  edit.Compact(0);
+  check();
+  TEST_ASSERT(edit.size() < size);
+  edit.Compact(256, flexbuffers::BIT_WIDTH_32);
+  check();
+  TEST_EQ(edit.slack(), 256u);
+  // Now wide enough to grow in place.
+  map = edit.GetRoot().AsMap();
+  TEST_EQ(edit.SetInt(map, "count", 2000000), true);
+  TEST_EQ(edit.slack(), 256u);
+  TEST_EQ(edit.SetString(map, "name", big.c_str()), true);
+  TEST_EQ(flexbuffers::VerifyBuffer(edit.data(), edit.size()), true);
+  TEST_EQ(edit.GetRoot().AsMap()["name"].AsString().str(), big);
+}
+
+void FlexBuffersEditableSharedStringsTest() {
+  flexbuffers::Builder fbb(512, flexbuffers::BUILDER_FLAG_SHARE_ALL);
+  fbb.Map([&]() {
+    fbb.String("a", "same");
+    fbb.String("b", "same");
+    fbb.Vector("c", [&]() {
+      fbb.String("same");
+      fbb.String("same");
+    });
+  });
+  fbb.Finish();
+  auto& doc = fbb.GetBuffer();
+  auto root = flexbuffers::GetRoot(doc).AsMap();
+  // All of them are the same string.
+  TEST_EQ(root["a"].AsString().c_str(), root["b"].AsString().c_str());
+  TEST_EQ(root["a"].AsString().c_str(),
+          root["c"].AsVector()[1].AsString().c_str());
+
+  flexbuffers::EditableFlexBuffer edit(doc.data(), doc.size(), 64);
+  auto map = edit.GetRoot().AsMap();
+  TEST_EQ(edit.SetString(map, "a", "diff"), true);
+  auto vec = edit.GetRoot().AsMap()["c"].AsVector();
+  TEST_EQ(edit.SetString(vec, 0, "more", 4), true);
+  TEST_EQ(flexbuffers::VerifyBuffer(edit.data(), edit.size()), true);
+  auto edited = edit.GetRoot().AsMap();
+  TEST_EQ_STR(edited["a"].AsString().c_str(), "diff");
+  TEST_EQ_STR(edited["b"].AsString().c_str(), "same");
+  TEST_EQ_STR(edited["c"].AsVector()[0].AsString().c_str(), "more");
+  TEST_EQ_STR(edited["c"].AsVector()[1].AsString().c_str(), "same");
+}
+
 void FlexBuffersFloatingPointTest() {
 #if defined(FLATBUFFERS_HAS_NEW_STRTOD) && (FLATBUFFERS_HAS_NEW_STRTOD > 0)
   flexbuffers::Builder slb(512,
@@ -6,6 +6,13 @@ namespace tests {
 
 void FlexBuffersTest();
 void FlexBuffersReuseBugTest();
+void FlexBuffersSharedKeyVectorsTest();
+void FlexBuffersMapKeyTest();
+void FlexBuffersStreamingBuilderTest();
+void FlexBuffersCopyToTest();
+void FlexBuffersVerifierReuseTest();
+void FlexBuffersEditableTest();
+void FlexBuffersEditableSharedStringsTest();
 void FlexBuffersFloatingPointTest();
 void FlexBuffersDeprecatedTest();
 void ParseFlexbuffersFromJsonWithNullTest();
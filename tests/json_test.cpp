@@ -124,6 +124,64 @@ void JsonOptionalTest(const std::string& tests_data_path,
   TEST_EQ_STR(jsongen.c_str(), jsonfile.c_str());
 }
 
+void JsonStreamingTest(const std::string& tests_data_path) {
+  std::string schemafile;
+  std::string jsonfile;
+  TEST_EQ(flatbuffers::LoadFile((tests_data_path + "monster_test.fbs").c_str(),
+                                false, &schemafile),
+          true);
+  TEST_EQ(flatbuffers::LoadFile(
+              (tests_data_path + "monsterdata_test.golden").c_str(), false,
+              &jsonfile),
+          true);
+  flatbuffers::Parser parser;
+  auto include_test_path =
+      flatbuffers::ConCatPathFileName(tests_data_path, "include_test");
+  const char* include_directories[] = {tests_data_path.c_str(),
+                                       include_test_path.c_str(), nullptr};
+  TEST_EQ(parser.Parse(schemafile.c_str(), include_directories), true);
+  TEST_EQ(parser.Parse(jsonfile.c_str(), include_directories), true);
+
+  std::string expected;
+  TEST_NULL(GenText(parser, parser.builder_.GetBufferPointer(), &expected));
+
+  // With a small buffer, the text arrives in many small parts.
+  std::string streamed;
+  size_t parts = 0;
+  size_t largest_part = 0;
+  flatbuffers::CallbackBufferSink sink(
+      [&](const uint8_t* data, size_t len) {
+        streamed.append(reinterpret_cast<const char*>(data), len);
+        parts++;
+        largest_part = (std::max)(largest_part, len);
+        return true;
+      });
+  TEST_NULL(GenText(parser, parser.builder_.GetBufferPointer(), sink, 64));
+  TEST_EQ_STR(streamed.c_str(), expected.c_str());
+  TEST_EQ(parts > expected.size() / 128, true);
+  TEST_EQ(largest_part < 256, true);
+
+  // A table by name, with a large buffer.
+  streamed.clear();
+  parts = 0;
+  auto monster = GetMonster(parser.builder_.GetBufferPointer());
+  TEST_NULL(
+      GenTextFromTable(parser, monster, "MyGame.Example.Monster", sink));
+  TEST_EQ_STR(streamed.c_str(), expected.c_str());
+  TEST_EQ(parts, 1u);
+
+  // Errors of the sink stop the output.
+  parts = 0;
+  flatbuffers::CallbackBufferSink failing_sink(
+      [&](const uint8_t*, size_t) {
+        parts++;
+        return false;
+      });
+  TEST_NOTNULL(
+      GenText(parser, parser.builder_.GetBufferPointer(), failing_sink, 64));
+  TEST_EQ(parts, 1u);
+}
+
 void ParseIncorrectMonsterJsonTest(const std::string& tests_data_path) {
   std::string schemafile;
   TEST_EQ(flatbuffers::LoadFile((tests_data_path + "monster_test.bfbs").c_str(),
@@ -170,6 +228,113 @@ void JsonUnsortedArrayTest() {
   TEST_NOTNULL(monster->testarrayoftables()->LookupByKey("ccc"));
 }
 
+void JsonEytzingerArrayTest() {
+  auto schema = R"(
+table Entry { k: int (key); }
+struct Pair { k: int (key); v: int; }
+table Root { entries: [Entry] (eytzinger); pairs: [Pair] (eytzinger); }
+root_type Root;
+)";
+  flatbuffers::Parser parser;
+  TEST_EQ(parser.Parse(schema), true);
+  TEST_EQ(parser.ParseJson(R"({
+    entries: [{k: 5}, {k: 3}, {k: 1}, {k: 7}, {k: 2}, {k: 4}, {k: 6}],
+    pairs: [{k: 5, v: 0}, {k: 3, v: 0}, {k: 1, v: 0}, {k: 2, v: 0}]
+  })"),
+          true);
+  auto root = flatbuffers::GetRoot<flatbuffers::Table>(
+      parser.builder_.GetBufferPointer());
+  auto entries =
+      root->GetPointer<const flatbuffers::Vector<flatbuffers::Offset<Table>>*>(
+          4);
+  const int expected_entries[] = {4, 2, 6, 1, 3, 5, 7};
+  TEST_EQ(entries->size(), 7u);
+  for (uoffset_t i = 0; i < entries->size(); i++) {
+    TEST_EQ(entries->Get(i)->GetField<int32_t>(4, 0), expected_entries[i]);
+  }
+  auto pairs = root->GetPointer<const flatbuffers::Vector<int64_t>*>(6);
+  const int expected_pairs[] = {3, 2, 5, 1};
+  TEST_EQ(pairs->size(), 4u);
+  for (uoffset_t i = 0; i < pairs->size(); i++) {
+    TEST_EQ(ReadScalar<int32_t>(pairs->Data() + i * 8), expected_pairs[i]);
+  }
+
+  flatbuffers::Parser parser2;
+  TEST_EQ(parser2.Parse("table T { k: [int] (eytzinger); }"), false);
+  // The elements need a key, even when they are defined later.
+  flatbuffers::Parser parser3;
+  TEST_EQ(parser3.Parse("table T { k: [U] (eytzinger); } table U { a: int; }"),
+          false);
+  flatbuffers::Parser parser4;
+  TEST_EQ(parser4.Parse("table T { k: [U] (eytzinger); } struct U { a: int; }"),
+          false);
+  flatbuffers::Parser parser5;
+  TEST_EQ(parser5.Parse(
+              "table T { k: [U] (eytzinger); } table U { a: int (key); }"),
+          true);
+  // Only C++ looks up keys in Eytzinger order.
+  flatbuffers::Parser parser6;
+  parser6.opts.lang_to_generate = IDLOptions::kCpp | IDLOptions::kRust;
+  TEST_EQ(parser6.Parse(
+              "table T { k: [U] (eytzinger); } table U { a: int (key); }"),
+          false);
+}
+
+void JsonDecoderTest() {
+  auto json = R"({
+    name: "decoded",
+    hp: 42,
+    pos: { x: 1, y: 2, z: 3, test1: 0, test2: "Red", test3: { a: 5, b: 6 } },
+    inventory: [1, 2, 3],
+    testarrayofstring: ["a", "bb", "ccc"],
+    testarrayoftables: [{ name: "ccc" }, { name: "aaa" }]
+  })";
+  flatbuffers::Parser parser;
+  TEST_EQ(parser.Deserialize(MyGame::Example::MonsterBinarySchema::data(),
+                             MyGame::Example::MonsterBinarySchema::size()),
+          true);
+  TEST_EQ(parser.ParseJson(json), true);
+  const std::vector<uint8_t> expected(
+      parser.builder_.GetBufferPointer(),
+      parser.builder_.GetBufferPointer() + parser.builder_.GetSize());
+
+  flatbuffers::JsonDecoder decoder(MyGame::Example::MonsterBinarySchema::data(),
+                                   MyGame::Example::MonsterBinarySchema::size());
+  TEST_EQ(decoder.ok(), true);
+  flatbuffers::FlatBufferBuilder builder;
+  // The same builder can be decoded into again and again.
+  for (int i = 0; i < 3; i++) {
+    TEST_EQ(decoder.Decode(json, builder), true);
+    TEST_EQ(builder.GetSize(), expected.size());
+    TEST_EQ(memcmp(builder.GetBufferPointer(), expected.data(),
+                   expected.size()),
+            0);
+  }
+  auto monster = GetMonster(builder.GetBufferPointer());
+  TEST_EQ_STR(monster->name()->c_str(), "decoded");
+  TEST_NOTNULL(monster->testarrayoftables()->LookupByKey("aaa"));
+
+  TEST_EQ(decoder.Decode("{name: 1}", builder), false);
+  TEST_EQ(decoder.error().empty(), false);
+  TEST_EQ(decoder.Decode(json, builder), true);
+  TEST_EQ(decoder.error().empty(), true);
+
+  // A decoder built from a parsed schema.
+  flatbuffers::Parser schema_parser;
+  TEST_EQ(schema_parser.Parse("table T { a: int; s: string; } root_type T;"),
+          true);
+  flatbuffers::JsonDecoder decoder2(schema_parser);
+  TEST_EQ(decoder2.ok(), true);
+  TEST_EQ(decoder2.Decode("{a: 7, s: \"x\"}", builder), true);
+  auto root = GetRoot<Table>(builder.GetBufferPointer());
+  TEST_EQ(root->GetField<int32_t>(4, 0), 7);
+
+  const uint8_t garbage[16] = { 4, 0, 0, 0, 'n', 'o', 'p', 'e' };
+  flatbuffers::JsonDecoder bad(garbage, sizeof(garbage));
+  TEST_EQ(bad.ok(), false);
+  TEST_EQ(bad.Decode(json, builder), false);
+}
+
 void JsonUnionStructTest() {
   // schema to parse data
   auto schema = R"(
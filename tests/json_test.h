@@ -9,8 +9,11 @@ namespace tests {
 void JsonDefaultTest(const std::string& tests_data_path);
 void JsonEnumsTest(const std::string& tests_data_path);
 void JsonOptionalTest(const std::string& tests_data_path, bool default_scalars);
+void JsonStreamingTest(const std::string& tests_data_path);
 void ParseIncorrectMonsterJsonTest(const std::string& tests_data_path);
 void JsonUnsortedArrayTest();
+void JsonEytzingerArrayTest();
+void JsonDecoderTest();
 void JsonUnionStructTest();
 
 }  // namespace tests
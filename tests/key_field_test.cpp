@@ -1,5 +1,6 @@
 #include "key_field_test.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include "flatbuffers/flatbuffers.h"
@@ -216,5 +217,46 @@ void FixedSizedStructArrayKeyInStructTest() {
       3);
 }
 
+void EytzingerKeyInGeneratedCodeTest() {
+  // The generated CreateXDirect() and Pack() lay out vectors with the
+  // `eytzinger` attribute in Eytzinger order.
+  const uint16_t ids[] = { 5, 3, 1, 7, 2, 4, 6 };
+  const char* names[] = { "e", "c", "a", "g", "b", "d", "f" };
+  auto check = [&](const FooTable* foo) {
+    const uint16_t eytzinger_ids[] = { 4, 2, 6, 1, 3, 5, 7 };
+    TEST_EQ(foo->i()->size(), 7u);
+    TEST_EQ(foo->j()->size(), 7u);
+    for (uoffset_t i = 0; i < 7; i++) {
+      TEST_EQ(foo->i()->Get(i)->id(), eytzinger_ids[i]);
+      TEST_EQ(foo->j()->Get(i)->height(), eytzinger_ids[i]);
+      TEST_EQ(foo->i()->LookupByKeyEytzinger(ids[i])->depth(), ids[i] * 2);
+      TEST_EQ(foo->j()->LookupByKeyEytzinger(names[i])->height(), ids[i]);
+    }
+    TEST_NULL(foo->i()->LookupByKeyEytzinger(static_cast<uint16_t>(8)));
+    TEST_NULL(foo->j()->LookupByKeyEytzinger("h"));
+  };
+
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<Pit> pits;
+  std::vector<flatbuffers::Offset<Tree>> trees;
+  for (size_t i = 0; i < 7; i++) {
+    pits.push_back(Pit(static_cast<uint8_t>(ids[i] * 2), ids[i]));
+    trees.push_back(CreateTreeDirect(fbb, ids[i], names[i]));
+  }
+  fbb.Finish(CreateFooTableDirect(fbb, 0, 0, "foo", nullptr, nullptr, nullptr,
+                                  nullptr, nullptr, &pits, &trees));
+  check(GetFooTable(fbb.GetBufferPointer()));
+
+  // Unpacking keeps the order, so shuffle the elements before packing again.
+  std::unique_ptr<FooTableT> foo(
+      GetFooTable(fbb.GetBufferPointer())->UnPack());
+  std::reverse(foo->i.begin(), foo->i.end());
+  std::swap(foo->j[0], foo->j[6]);
+  std::swap(foo->j[2], foo->j[3]);
+  flatbuffers::FlatBufferBuilder fbb2;
+  fbb2.Finish(FooTable::Pack(fbb2, foo.get()));
+  check(GetFooTable(fbb2.GetBufferPointer()));
+}
+
 }  // namespace tests
 }  // namespace flatbuffers
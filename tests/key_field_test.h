@@ -8,6 +8,7 @@ void FixedSizedScalarKeyInStructTest();
 void StructKeyInStructTest();
 void NestedStructKeyInStructTest();
 void FixedSizedStructArrayKeyInStructTest();
+void EytzingerKeyInGeneratedCodeTest();
 
 }  // namespace tests
 }  // namespace flatbuffers
@@ -342,6 +342,27 @@ void AccessFlatBufferTest(const uint8_t* flatbuf, size_t length, bool pooled) {
   TEST_NULL(vecoftables->LookupByKey(invalid_truncated_key));
 #endif  // FLATBUFFERS_HAS_STRING_VIEW
 
+  // Lookups through a cache give the same results, the second time without
+  // a binary search.
+  flatbuffers::KeyLookupCache lookup_cache(16);
+  for (int i = 0; i < 2; i++) {
+    TEST_EQ(vecoftables->LookupByKey("Fred", lookup_cache),
+            vecoftables->Get(1));
+    TEST_EQ(vecoftables->LookupByKey(std::string("Wilma"), lookup_cache),
+            vecoftables->Get(2));
+    TEST_NULL(vecoftables->LookupByKey("Betty", lookup_cache));
+  }
+  // Mutable C-strings and char arrays are compared and hashed by their
+  // contents, so reusing a buffer for another key finds that key.
+  char key_buf[16] = "Fred";
+  char* key_ptr = key_buf;
+  TEST_EQ(vecoftables->LookupByKey(key_ptr, lookup_cache), vecoftables->Get(1));
+  TEST_EQ(vecoftables->LookupByKey(key_buf, lookup_cache), vecoftables->Get(1));
+  strcpy(key_buf, "Wilma");
+  TEST_EQ(vecoftables->LookupByKey(key_ptr, lookup_cache), vecoftables->Get(2));
+  TEST_EQ(vecoftables->LookupByKey(key_buf, lookup_cache), vecoftables->Get(2));
+  TEST_EQ(vecoftables->LookupByKey(key_ptr), vecoftables->Get(2));
+
   // Test accessing a vector of sorted structs
   auto vecofstructs = monster->testarrayofsortedstruct();
   if (vecofstructs) {  // not filled in monster_test.bfbs
@@ -353,6 +374,10 @@ void AccessFlatBufferTest(const uint8_t* flatbuf, size_t length, bool pooled) {
     TEST_NOTNULL(vecofstructs->LookupByKey(0));  // test default value
     TEST_NOTNULL(vecofstructs->LookupByKey(3));
     TEST_EQ(static_cast<const Ability*>(nullptr), vecofstructs->LookupByKey(5));
+    TEST_EQ(vecofstructs->LookupByKey(3, lookup_cache),
+            vecofstructs->LookupByKey(3));
+    TEST_EQ(vecofstructs->LookupByKey(3, lookup_cache),
+            vecofstructs->LookupByKey(3));
   }
 
   if (auto vec_of_stat = monster->scalar_key_sorted_tables()) {
@@ -734,6 +759,58 @@ void EnumNamesTest() {
   TEST_EQ_STR("", EnumNameColor(static_cast<Color>(Color_ANY + 1)));
 }
 
+void EytzingerLayoutTest() {
+  for (size_t len = 0; len < 40; len++) {
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<flatbuffers::Offset<Monster>> monsters;
+    std::vector<Ability> abilities;
+    // Added in reverse, the builder sorts them.
+    for (size_t i = len; i > 0; i--) {
+      auto name = builder.CreateString("m" + NumToString(i * 10));
+      monsters.push_back(CreateMonster(builder, nullptr, 0, 0, name));
+      abilities.push_back(Ability(static_cast<uint32_t>(i * 10), 0));
+    }
+    auto tables = builder.CreateVectorOfEytzingerTables(&monsters);
+    auto structs = builder.CreateVectorOfEytzingerStructs(&abilities);
+    auto name = builder.CreateString("root");
+    MonsterBuilder mb(builder);
+    mb.add_name(name);
+    mb.add_testarrayoftables(tables);
+    mb.add_testarrayofsortedstruct(structs);
+    builder.Finish(mb.Finish());
+
+    auto monster = GetMonster(builder.GetBufferPointer());
+    auto vecoftables = monster->testarrayoftables();
+    auto vecofstructs = monster->testarrayofsortedstruct();
+    TEST_EQ(vecoftables->size(), len);
+    if (len >= 3) {
+      // The middle element comes first.
+      TEST_EQ(vecofstructs->Get(1)->id() < vecofstructs->Get(0)->id(), true);
+      TEST_EQ(vecofstructs->Get(0)->id() < vecofstructs->Get(2)->id(), true);
+    }
+    for (size_t i = 0; i <= len + 1; i++) {
+      auto key = "m" + NumToString(i * 10);
+      auto found = vecoftables->LookupByKeyEytzinger(key.c_str());
+      auto found_struct =
+          vecofstructs->LookupByKeyEytzinger(static_cast<uint32_t>(i * 10));
+      if (i >= 1 && i <= len) {
+        TEST_NOTNULL(found);
+        TEST_EQ_STR(found->name()->c_str(), key.c_str());
+        TEST_NOTNULL(found_struct);
+        TEST_EQ(found_struct->id(), i * 10);
+      } else {
+        TEST_NULL(found);
+        TEST_NULL(found_struct);
+      }
+      // Between two keys.
+      TEST_NULL(vecoftables->LookupByKeyEytzinger(
+          ("m" + NumToString(i * 10 + 5)).c_str()));
+      TEST_NULL(vecofstructs->LookupByKeyEytzinger(
+          static_cast<uint32_t>(i * 10 + 5)));
+    }
+  }
+}
+
 void TypeAliasesTest() {
   flatbuffers::FlatBufferBuilder builder;
 
@@ -28,6 +28,8 @@ void EnumNamesTest();
 
 void TypeAliasesTest();
 
+void EytzingerLayoutTest();
+
 void ParseAndGenerateTextTest(const std::string& tests_data_path, bool binary);
 
 void UnPackTo(const uint8_t* flatbuf);
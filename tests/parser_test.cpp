@@ -805,6 +805,49 @@ void UnicodeSurrogatesTest() {
   TEST_EQ_STR(string->c_str(), "\xF0\x9F\x92\xA9");
 }
 
+void StringScanningTest() {
+  // Strings and blanks are scanned in blocks, try them at every alignment
+  // and with the interesting characters on either side of block boundaries.
+  const std::string plain = "abcdefghijklmnopqrstuvwxyz0123456789 'single'";
+  for (size_t shift = 0; shift < 40; shift++) {
+    const std::string blanks = std::string(shift, ' ') + "\t\r " +
+                               std::string(shift % 17, ' ');
+    const std::string head = plain.substr(0, shift);
+    flatbuffers::Parser parser;
+    const std::string json = "table T { F:string (id: 0); } root_type T;" +
+                             blanks + "{" + blanks + "F:" + blanks + "\"" +
+                             head + "\\n\xC3\xA9" + plain + "\"" +
+                             blanks + "}";
+    TEST_EQ(parser.Parse(json.c_str()), true);
+    auto root = flatbuffers::GetRoot<flatbuffers::Table>(
+        parser.builder_.GetBufferPointer());
+    auto string = root->GetPointer<flatbuffers::String*>(
+        flatbuffers::FieldIndexToOffset(0));
+    TEST_EQ(string->str(), head + "\n\xC3\xA9" + plain);
+
+    flatbuffers::Parser bad_utf8;
+    TEST_EQ(bad_utf8.Parse(("table T { F:string; } root_type T; { F:\"" +
+                            plain + head + "\x80" + plain + "\" }")
+                               .c_str()),
+            false);
+    TEST_NOTNULL(strstr(bad_utf8.error_.c_str(), "illegal UTF-8 sequence"));
+
+    flatbuffers::Parser control;
+    TEST_EQ(control.Parse(("table T { F:string; } root_type T; { F:\"" +
+                           plain + head + "\x01" + plain + "\" }")
+                              .c_str()),
+            false);
+    TEST_NOTNULL(strstr(control.error_.c_str(), "illegal character"));
+
+    flatbuffers::Parser unterminated;
+    TEST_EQ(
+        unterminated.Parse(("table T { F:string; } root_type T; { F:\"" +
+                            plain + head)
+                               .c_str()),
+        false);
+  }
+}
+
 void UnknownFieldsTest() {
   flatbuffers::IDLOptions opts;
   opts.skip_unexpected_fields_in_json = true;
@@ -935,5 +978,46 @@ void FieldIdentifierTest() {
 #endif
 }
 
+void BinaryDefaultsTest() {
+  flatbuffers::Parser parser;
+  TEST_EQ(parser.Parse("table T { a: short = 7; b: float = 1.5; c: bool = true;"
+                       " d: int = null; } root_type T;"),
+          true);
+  // The defaults are in binary once the schema is parsed, so parsing data
+  // never writes to the schema.
+  auto check = [](const flatbuffers::Parser& p) {
+    const auto& fields = p.structs_.Lookup("T")->fields;
+    // The binary form holds the bits of the C type.
+    int16_t a;
+    float b;
+    uint8_t c;
+    TEST_EQ(fields.Lookup("a")->value.has_binary, true);
+    memcpy(&a, &fields.Lookup("a")->value.binary, sizeof(a));
+    TEST_EQ(a, 7);
+    TEST_EQ(fields.Lookup("b")->value.has_binary, true);
+    memcpy(&b, &fields.Lookup("b")->value.binary, sizeof(b));
+    TEST_EQ(b, 1.5f);
+    TEST_EQ(fields.Lookup("c")->value.has_binary, true);
+    memcpy(&c, &fields.Lookup("c")->value.binary, sizeof(c));
+    TEST_EQ(c, 1);
+    TEST_EQ(fields.Lookup("d")->value.has_binary, false);
+  };
+  check(parser);
+  TEST_EQ(parser.ParseJson("{ a: 7, b: 2, c: false }"), true);
+  check(parser);
+  auto root = flatbuffers::GetRoot<flatbuffers::Table>(
+      parser.builder_.GetBufferPointer());
+  TEST_EQ(root->CheckField(4), false);
+  TEST_EQ(root->GetField<float>(6, 0), 2.0f);
+  TEST_EQ(root->GetField<uint8_t>(8, 1), 0);
+
+  parser.Serialize();
+  flatbuffers::Parser deserialized;
+  TEST_EQ(deserialized.Deserialize(parser.builder_.GetBufferPointer(),
+                                   parser.builder_.GetSize()),
+          true);
+  check(deserialized);
+}
+
 }  // namespace tests
 }  // namespace flatbuffers
@@ -20,12 +20,14 @@ void UnicodeTest();
 void UnicodeTestAllowNonUTF8();
 void UnicodeTestGenerateTextFailsOnNonUTF8();
 void UnicodeSurrogatesTest();
+void StringScanningTest();
 void UnknownFieldsTest();
 void ParseUnionTest();
 void ValidSameNameDifferentNamespaceTest();
 void WarningsAsErrorsTest();
 void StringVectorDefaultsTest();
 void FieldIdentifierTest();
+void BinaryDefaultsTest();
 
 }  // namespace tests
 }  // namespace flatbuffers
@@ -1,5 +1,7 @@
 #include "reflection_test.h"
 
+#include "flatbuffers/flex_flat_util.h"
+#include "flatbuffers/idl.h"
 #include "flatbuffers/minireflect.h"
 #include "flatbuffers/reflection.h"
 #include "flatbuffers/reflection_generated.h"
@@ -248,6 +250,146 @@ void ReflectionTest(const std::string& tests_data_path, uint8_t* flatbuf,
           true);
 }
 
+void FlexToFlatTest(const std::string& tests_data_path) {
+  std::string bfbsfile;
+  TEST_EQ(flatbuffers::LoadFile((tests_data_path + "monster_test.bfbs").c_str(),
+                                true, &bfbsfile),
+          true);
+  auto& schema = *reflection::GetSchema(bfbsfile.c_str());
+
+  std::string schemafile;
+  TEST_EQ(flatbuffers::LoadFile((tests_data_path + "monster_test.fbs").c_str(),
+                                false, &schemafile),
+          true);
+  flatbuffers::Parser parser;
+  auto include_test_path =
+      flatbuffers::ConCatPathFileName(tests_data_path, "include_test");
+  const char* include_directories[] = {tests_data_path.c_str(),
+                                       include_test_path.c_str(), nullptr};
+  TEST_EQ(parser.Parse(schemafile.c_str(), include_directories), true);
+
+  const char* json =
+      "{ pos: { x: 1.0, y: 2.0, z: 3.0, test1: 3.5, test2: \"Green\", "
+      "test3: { a: 10, b: 20 } }, hp: 80, name: \"MyMonster\", "
+      "color: \"Red Blue\", inventory: [0, 1, 2, 255], "
+      "test_type: \"Monster\", test: { name: \"Fred\" }, "
+      "test4: [{ a: 10, b: 20 }, { a: 30, b: 40 }], "
+      "testarrayofstring: [\"bob\", \"fred\"], "
+      "testarrayoftables: [{ name: \"Wilma\", testf: 1.5 }, "
+      "{ hp: 1000, name: \"Barney\" }, { name: \"Betty\" }], "
+      "testbool: true, "
+      "testarrayofsortedstruct: [{ id: 5, distance: 1 }, "
+      "{ id: 1, distance: 2 }, { id: 3, distance: 3 }], "
+      "vector_of_longs: [1, -100, 10000000000], "
+      "vector_of_enums: [\"Blue\", \"Green\"], "
+      "scalar_key_sorted_tables: [{ id: \"b\", count: 2 }, { id: \"a\" }] }";
+
+  // Convert the schemaless FlexBuffer version of the JSON ...
+  flexbuffers::Builder flex;
+  TEST_EQ(parser.ParseFlexBuffer(json, nullptr, &flex), true);
+  flatbuffers::FlatBufferBuilder fbb;
+  std::string error;
+  TEST_EQ(flexbuffers::FlexToFlatBuffer(
+              schema, flexbuffers::GetRoot(flex.GetBuffer()), fbb, &error),
+          true);
+  TEST_EQ_STR(error.c_str(), "");
+  TEST_EQ(flatbuffers::Verify(schema, *schema.root_table(),
+                              fbb.GetBufferPointer(), fbb.GetSize()),
+          true);
+  TEST_EQ(MonsterBufferHasIdentifier(fbb.GetBufferPointer()), true);
+
+  // Keyed vectors are sorted, like the JSON parser does.
+  auto monster = GetMonster(fbb.GetBufferPointer());
+  TEST_EQ_STR(monster->testarrayoftables()->Get(0)->name()->c_str(), "Barney");
+  TEST_EQ(monster->testarrayoftables()->LookupByKey("Wilma")->testf(), 1.5f);
+  TEST_EQ(monster->testarrayofsortedstruct()->LookupByKey(5)->distance(), 1u);
+  TEST_EQ(monster->testarrayofsortedstruct()->Get(0)->id(), 1u);
+  TEST_EQ_STR(monster->scalar_key_sorted_tables()->LookupByKey(2)->id()->c_str(),
+              "b");
+  TEST_EQ_STR(monster->scalar_key_sorted_tables()->Get(0)->id()->c_str(), "a");
+
+  // ... and compare it with what the JSON parser makes of it.
+  TEST_EQ(parser.ParseJson(json), true);
+  std::string expected;
+  TEST_NULL(GenText(parser, parser.builder_.GetBufferPointer(), &expected));
+  std::string converted;
+  TEST_NULL(GenText(parser, fbb.GetBufferPointer(), &converted));
+  TEST_EQ_STR(converted.c_str(), expected.c_str());
+
+  auto check_error = [&](const char* bad_json, const char* message) {
+    flex.Clear();
+    TEST_EQ(parser.ParseFlexBuffer(bad_json, nullptr, &flex), true);
+    flatbuffers::FlatBufferBuilder bad_fbb;
+    std::string bad_error;
+    TEST_EQ(flexbuffers::FlexToFlatBuffer(
+                schema, flexbuffers::GetRoot(flex.GetBuffer()), bad_fbb,
+                &bad_error),
+            false);
+    TEST_EQ_STR(bad_error.c_str(), message);
+  };
+  check_error("{ name: \"a\", nope: 1 }", "unknown field: nope");
+  check_error("{ hp: 1 }", "missing required field: name");
+  check_error("{ name: \"a\", color: \"Purple\" }",
+              "unknown enum value: Purple");
+  check_error("{ name: \"a\", test: { name: \"b\" } }",
+              "missing union type for field: test");
+  check_error("{ name: \"a\", pos: { x: 1.0 } }", "missing struct field: test1");
+  check_error("{ name: 1 }", "expected a string for field: name");
+  check_error("{ name: \"a\", inventory: 1 }",
+              "expected a vector for field: inventory");
+  check_error("{ name: \"a\", inventory: [1, 300] }",
+              "constant does not fit [0; 255] for field: inventory");
+  check_error("{ name: \"a\", hp: -40000 }",
+              "constant does not fit [-32768; 32767] for field: hp");
+  check_error("{ name: \"a\", hp: 1.5 }", "expected an integer for field: hp");
+  check_error("{ name: \"a\", long_enum_normal_default: -1 }",
+              "constant does not fit [0; 18446744073709551615] for field: "
+              "long_enum_normal_default");
+
+  // Vectors with the `eytzinger` attribute are sorted and then reordered.
+  flatbuffers::Parser eytzinger_parser;
+  TEST_EQ(eytzinger_parser.Parse(
+              "struct Point { id:int (key); x:int; }"
+              "table Item { name:string (key); }"
+              "table Root { points:[Point] (eytzinger); "
+              "items:[Item] (eytzinger); }"
+              "root_type Root;"),
+          true);
+  eytzinger_parser.Serialize();
+  std::string eytzinger_bfbs(
+      reinterpret_cast<const char*>(
+          eytzinger_parser.builder_.GetBufferPointer()),
+      eytzinger_parser.builder_.GetSize());
+  auto& eytzinger_schema = *reflection::GetSchema(eytzinger_bfbs.data());
+  const char* eytzinger_json =
+      "{ points: [{ id: 3, x: 0 }, { id: 5, x: 0 }, { id: 1, x: 0 }, "
+      "{ id: 4, x: 0 }, { id: 2, x: 0 }], "
+      "items: [{ name: \"c\" }, { name: \"a\" }, { name: \"b\" }] }";
+  flex.Clear();
+  TEST_EQ(eytzinger_parser.ParseFlexBuffer(eytzinger_json, nullptr, &flex),
+          true);
+  flatbuffers::FlatBufferBuilder eytzinger_fbb;
+  TEST_EQ(flexbuffers::FlexToFlatBuffer(
+              eytzinger_schema, flexbuffers::GetRoot(flex.GetBuffer()),
+              eytzinger_fbb, &error),
+          true);
+  TEST_EQ(eytzinger_parser.ParseJson(eytzinger_json), true);
+  std::string eytzinger_expected;
+  TEST_NULL(GenText(eytzinger_parser,
+                    eytzinger_parser.builder_.GetBufferPointer(),
+                    &eytzinger_expected));
+  std::string eytzinger_converted;
+  TEST_NULL(GenText(eytzinger_parser, eytzinger_fbb.GetBufferPointer(),
+                    &eytzinger_converted));
+  TEST_EQ_STR(eytzinger_converted.c_str(), eytzinger_expected.c_str());
+  // Of the ids 1 to 5, the middle one is the root of the implicit tree.
+  auto points = flatbuffers::GetFieldAnyV(
+      *flatbuffers::GetAnyRoot(eytzinger_fbb.GetBufferPointer()),
+      *eytzinger_schema.root_table()->fields()->LookupByKey("points"));
+  TEST_EQ(points->size(), 5u);
+  TEST_EQ(flatbuffers::ReadScalar<int32_t>(points->Data()), 4);
+}
+
 void MiniReflectFlatBuffersTest(uint8_t* flatbuf) {
   auto s =
       flatbuffers::FlatBufferToString(flatbuf, Monster::MiniReflectTypeTable());
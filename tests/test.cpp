@@ -36,6 +36,7 @@
 #include "alignment_test.h"
 #include "default_vectors_strings_test.h"
 #include "evolution_test.h"
+#include "flatbuffers/flatbuffer_builder_pool.h"
 #include "flatbuffers/flatbuffers.h"
 #include "flatbuffers/idl.h"
 #include "flatbuffers/minireflect.h"
@@ -65,6 +66,7 @@
 #include "monster_test_bfbs_generated.h"  // Generated using --bfbs-comments --bfbs-builtins --cpp --bfbs-gen-embed
 #include "native_type_test_generated.h"
 #include "test_assert.h"
+#include "test_parallel_for.h"
 #include "util_test.h"
 #include "vector_table_naked_ptr_test.h"
 
@@ -409,6 +411,42 @@ void EndianSwapTest() {
   TEST_EQ(flatbuffers::EndianSwap(flatbuffers::EndianSwap(3.14f)), 3.14f);
 }
 
+void BulkEndianVectorTest() {
+  // The byte swapping path is only taken on big endian hosts, so test it
+  // directly as well.
+  const double src[] = {1.5, -2.25, 3.0e100, 0.0, 42.0};
+  double swapped[5];
+  flatbuffers::EndianSwapCopy(swapped, src, 5);
+  for (int i = 0; i < 5; i++) {
+    TEST_EQ(flatbuffers::EndianSwap(swapped[i]), src[i]);
+  }
+
+  flatbuffers::FlatBufferBuilder builder;
+  const std::vector<double> doubles(src, src + 5);
+  const int32_t ints[] = {-1, 2, -300, 40000, 5};
+  const auto doubles_offset = builder.CreateVector(doubles);
+  const auto casts_offset =
+      builder.CreateVectorScalarCast<int64_t>(ints, sizeof(ints) / 4);
+  const auto start = builder.StartTable();
+  builder.AddOffset(flatbuffers::FieldIndexToOffset(0), doubles_offset);
+  builder.AddOffset(flatbuffers::FieldIndexToOffset(1), casts_offset);
+  builder.Finish(
+      flatbuffers::Offset<flatbuffers::Table>(builder.EndTable(start)));
+
+  auto root =
+      flatbuffers::GetRoot<flatbuffers::Table>(builder.GetBufferPointer());
+  auto doubles_vec = root->GetPointer<const flatbuffers::Vector<double>*>(
+      flatbuffers::FieldIndexToOffset(0));
+  auto casts_vec = root->GetPointer<const flatbuffers::Vector<int64_t>*>(
+      flatbuffers::FieldIndexToOffset(1));
+  double doubles_out[5];
+  doubles_vec->CopyTo(doubles_out, doubles_vec->size());
+  for (int i = 0; i < 5; i++) TEST_EQ(doubles_out[i], src[i]);
+  int64_t casts_out[3];
+  casts_vec->CopyTo(casts_out, 3, 2);
+  for (int i = 0; i < 3; i++) TEST_EQ(casts_out[i], ints[i + 2]);
+}
+
 void UninitializedVectorTest() {
   flatbuffers::FlatBufferBuilder builder;
 
@@ -590,8 +628,7 @@ void CreateSharedStringTest() {
   TEST_EQ(a[5]->str(), (std::string(chars_c, sizeof(chars_c))));
   TEST_EQ(a[6]->str(), (std::string(chars_b, sizeof(chars_b))));
 
-  // Make sure String::operator< works, too, since it is related to
-  // StringOffsetCompare.
+  // Make sure String::operator< works, too.
   TEST_EQ((*a[0]) < (*a[1]), true);
   TEST_EQ((*a[1]) < (*a[0]), false);
   TEST_EQ((*a[1]) < (*a[2]), false);
@@ -602,6 +639,317 @@ void CreateSharedStringTest() {
   TEST_EQ((*a[6]) < (*a[5]), true);
 }
 
+// Builds parts of a buffer in separate builders, as worker threads would, and
+// splices them into one.
+void SpliceBuilderTest() {
+  for (bool hash_vtables : {false, true}) {
+    flatbuffers::FlatBufferBuilder workers[3];
+    std::vector<flatbuffers::Offset<Monster>> monsters[3];
+    flatbuffers::Offset<flatbuffers::String> shared[3];
+    flatbuffers::Offset<flatbuffers::Table> small_table[3];
+    for (int w = 0; w < 3; w++) {
+      workers[w].HashVtables(hash_vtables);
+      // Vary the alignment of the parts.
+      if (w == 1) workers[w].CreateVector(std::vector<int64_t>(1, 1));
+      shared[w] = workers[w].CreateSharedString("shared");
+      for (int i = 0; i < 10; i++) {
+        const std::string name =
+            "monster" + flatbuffers::NumToString(w * 10 + i);
+        monsters[w].push_back(CreateMonsterDirect(
+            workers[w], nullptr, 0, static_cast<int16_t>(w * 10 + i),
+            name.c_str()));
+      }
+      const auto start = workers[w].StartTable();
+      workers[w].AddElement<uint32_t>(flatbuffers::FieldIndexToOffset(0), 7);
+      small_table[w] =
+          flatbuffers::Offset<flatbuffers::Table>(workers[w].EndTable(start));
+    }
+
+    flatbuffers::FlatBufferBuilder builder;
+    builder.HashVtables(hash_vtables);
+    builder.CreateString("some data before the parts");
+    std::vector<flatbuffers::Offset<Monster>> all_monsters;
+    for (int w = 0; w < 3; w++) {
+      const auto delta = builder.Splice(workers[w]);
+      for (auto m : monsters[w]) {
+        all_monsters.push_back(builder.Relocate(m, delta));
+      }
+      shared[w] = builder.Relocate(shared[w], delta);
+      small_table[w] = builder.Relocate(small_table[w], delta);
+    }
+    // Strings and vtables of the parts are deduplicated against.
+    TEST_EQ(builder.CreateSharedString("shared").o, shared[0].o);
+    // Same start alignment as in the workers, so the vtables are identical.
+    builder.Align(sizeof(uint32_t));
+    const auto size_before_table = builder.GetSize();
+    const auto start = builder.StartTable();
+    builder.AddElement<uint32_t>(flatbuffers::FieldIndexToOffset(0), 7);
+    builder.EndTable(start);
+    TEST_EQ(builder.GetSize() - size_before_table, 8u);
+
+    const auto name = builder.CreateString("root");
+    const auto vec = builder.CreateVector(all_monsters);
+    MonsterBuilder root(builder);
+    root.add_name(name);
+    root.add_testarrayoftables(vec);
+    FinishMonsterBuffer(builder, root.Finish());
+
+    flatbuffers::Verifier verifier(builder.GetBufferPointer(),
+                                   builder.GetSize());
+    TEST_EQ(VerifyMonsterBuffer(verifier), true);
+    auto monster = GetMonster(builder.GetBufferPointer());
+    TEST_EQ(monster->testarrayoftables()->size(), 30u);
+    for (uint32_t i = 0; i < 30; i++) {
+      auto m = monster->testarrayoftables()->Get(i);
+      TEST_EQ(m->hp(), static_cast<int16_t>(i));
+      TEST_EQ(m->name()->str(), "monster" + flatbuffers::NumToString(i));
+    }
+    for (int w = 0; w < 3; w++) {
+      TEST_EQ_STR(flatbuffers::GetTemporaryPointer(builder, shared[w])->c_str(),
+                  "shared");
+      TEST_EQ(flatbuffers::GetTemporaryPointer(builder, small_table[w])
+                  ->GetField<uint32_t>(flatbuffers::FieldIndexToOffset(0), 0),
+              7u);
+    }
+  }
+}
+
+// Builds a buffer much larger than the builder's initial size, writing it out
+// to a sink while building.
+void StreamingBuilderTest() {
+  auto build = [](flatbuffers::FlatBufferBuilder& builder) {
+    std::vector<flatbuffers::Offset<Monster>> monsters;
+    for (int i = 0; i < 200; i++) {
+      const std::string name = "monster" + flatbuffers::NumToString(i);
+      monsters.push_back(CreateMonsterDirect(
+          builder, nullptr, 0, static_cast<int16_t>(i), name.c_str()));
+    }
+    const auto vec = builder.CreateVector(monsters);
+    const auto name = builder.CreateSharedString("root");
+    MonsterBuilder root(builder);
+    root.add_name(name);
+    root.add_testarrayoftables(vec);
+    FinishMonsterBuffer(builder, root.Finish());
+  };
+
+  for (bool dedup : {false, true}) {
+    flatbuffers::FlatBufferBuilder expected;
+    expected.DedupVtables(dedup);
+    build(expected);
+
+    std::vector<uint8_t> sink_data;
+    flatbuffers::CallbackBufferSink sink(
+        [&](const uint8_t* data, size_t len) {
+          sink_data.insert(sink_data.end(), data, data + len);
+          return true;
+        });
+    flatbuffers::FlatBufferBuilder builder(256);
+    builder.DedupVtables(dedup);
+    builder.StreamTo(&sink);
+    build(builder);
+    const size_t size = builder.GetSize();
+    TEST_EQ(builder.GetCapacity() < size, true);
+    std::vector<flatbuffers::BufferSegment> segments;
+    TEST_EQ(builder.ReleaseSegments(&segments), true);
+    TEST_EQ(builder.GetSize(), 0u);
+    TEST_EQ(sink_data.size(), size);
+    TEST_EQ(segments.size() > 1, true);
+    TEST_EQ(segments.back().buffer_offset, 0u);
+
+    std::vector<uint8_t> buf(size);
+    flatbuffers::AssembleBufferSegments(sink_data.data(), segments,
+                                        buf.data());
+    flatbuffers::Verifier verifier(buf.data(), buf.size());
+    TEST_EQ(VerifyMonsterBuffer(verifier), true);
+    auto monster = GetMonster(buf.data());
+    TEST_EQ_STR(monster->name()->c_str(), "root");
+    TEST_EQ(monster->testarrayoftables()->size(), 200u);
+    for (uint32_t i = 0; i < 200; i++) {
+      auto m = monster->testarrayoftables()->Get(i);
+      TEST_EQ(m->hp(), static_cast<int16_t>(i));
+      TEST_EQ(m->name()->str(), "monster" + flatbuffers::NumToString(i));
+    }
+    // Without dedup, nothing depends on what is still in memory.
+    if (!dedup) {
+      TEST_EQ(buf.size(), expected.GetSize());
+      TEST_EQ(memcmp(buf.data(), expected.GetBufferPointer(), buf.size()), 0);
+    }
+  }
+}
+
+// Shared strings are only reused while all of them is still in memory, as
+// the sink may be handed the end of a string while its length stays behind.
+void StreamingSharedStringTest() {
+  for (size_t n = 0; n < 200; n++) {
+    const size_t initial_size = 16 + (n % 8) * 4;
+    const size_t len = 1 + n / 2;
+    std::vector<uint8_t> sink_data;
+    flatbuffers::CallbackBufferSink sink(
+        [&](const uint8_t* data, size_t size) {
+          sink_data.insert(sink_data.end(), data, data + size);
+          return true;
+        });
+    flatbuffers::FlatBufferBuilder builder(initial_size);
+    builder.StreamTo(&sink);
+    const std::string str(len, static_cast<char>('a' + len % 26));
+    std::vector<flatbuffers::Offset<flatbuffers::String>> strings;
+    strings.push_back(builder.CreateSharedString("x"));
+    strings.push_back(builder.CreateSharedString(str));
+    strings.push_back(builder.CreateSharedString(str));
+    strings.push_back(builder.CreateSharedString("x"));
+    builder.Finish(builder.CreateVector(strings));
+
+    std::vector<flatbuffers::BufferSegment> segments;
+    TEST_EQ(builder.ReleaseSegments(&segments), true);
+    std::vector<uint8_t> buf(sink_data.size());
+    flatbuffers::AssembleBufferSegments(sink_data.data(), segments,
+                                        buf.data());
+    auto vec = flatbuffers::GetRoot<
+        flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>>(
+        buf.data());
+    TEST_EQ(vec->size(), 4u);
+    TEST_EQ_STR(vec->Get(0)->c_str(), "x");
+    TEST_EQ(vec->Get(1)->str(), str);
+    TEST_EQ(vec->Get(2)->str(), str);
+    TEST_EQ_STR(vec->Get(3)->c_str(), "x");
+  }
+}
+
+void FlatBufferBuilderPoolTest() {
+  flatbuffers::FlatBufferBuilderPool::Options opts;
+  opts.high_water_mark = 64 * 1024;
+  flatbuffers::FlatBufferBuilderPool pool(opts);
+
+  const uint8_t* first_data = nullptr;
+  flatbuffers::FlatBufferBuilder* first_builder = nullptr;
+  for (int i = 0; i < 3; i++) {
+    auto builder = pool.Acquire();
+    // Idle builders are handed out again.
+    if (first_builder) TEST_EQ(builder.get(), first_builder);
+    first_builder = builder.get();
+    TEST_EQ(builder->GetSize(), 0u);
+    builder->Finish(builder->CreateString("hello"));
+    flatbuffers::DetachedBuffer buf = builder->Release();
+    TEST_EQ_STR(flatbuffers::GetRoot<flatbuffers::String>(buf.data())->c_str(),
+                "hello");
+    // The memory of the released buffer is reused by the next builder, once
+    // the buffer is destroyed.
+    if (first_data) TEST_EQ(buf.data(), first_data);
+    first_data = buf.data();
+  }
+
+  {
+    // Builders keep their buffer warm, unless it grew too large.
+    auto small = pool.Acquire();
+    auto large = pool.Acquire();
+    small->CreateString(std::string(1024, 'x'));
+    large->CreateString(std::string(opts.high_water_mark, 'x'));
+    small->Clear();
+    large->Clear();
+    TEST_EQ(small->GetCapacity() > 0, true);
+    TEST_EQ(large->GetCapacity() > opts.high_water_mark, true);
+    auto small_builder = small.get();
+    auto large_builder = large.get();
+    {
+      auto moved_small = std::move(small);
+      auto moved_large = std::move(large);
+    }
+    TEST_EQ(small_builder->GetCapacity() > 0, true);
+    TEST_EQ(large_builder->GetCapacity(), 0u);
+  }
+
+  pool.Trim();
+}
+
+// Interleaves shared strings with tables, so the string pool has to grow
+// underneath the vtables that share the scratch area with it.
+void SharedStringPoolTest() {
+  for (bool hash_vtables : {false, true}) {
+    flatbuffers::FlatBufferBuilder builder;
+    builder.HashVtables(hash_vtables);
+    for (int pass = 0; pass < 2; pass++) {
+      std::vector<flatbuffers::Offset<flatbuffers::String>> strings;
+      std::vector<flatbuffers::Offset<flatbuffers::Table>> tables;
+      for (uint16_t i = 0; i < 200; i++) {
+        strings.push_back(
+            builder.CreateSharedString(flatbuffers::NumToString(i % 100)));
+        const auto start = builder.StartTable();
+        builder.AddElement<uint8_t>(flatbuffers::FieldIndexToOffset(i % 50),
+                                    1, 0);
+        tables.push_back(
+            flatbuffers::Offset<flatbuffers::Table>(builder.EndTable(start)));
+      }
+      // Hits are found without writing anything.
+      const auto size = builder.GetSize();
+      for (uint16_t i = 0; i < 100; i++) {
+        TEST_EQ(builder.CreateSharedString(flatbuffers::NumToString(i)).o,
+                strings[i].o);
+      }
+      TEST_EQ(builder.GetSize(), size);
+      const auto strings_offset = builder.CreateVector(strings);
+      const auto tables_offset = builder.CreateVector(tables);
+      const auto start = builder.StartTable();
+      builder.AddOffset(flatbuffers::FieldIndexToOffset(0), strings_offset);
+      builder.AddOffset(flatbuffers::FieldIndexToOffset(1), tables_offset);
+      builder.Finish(
+          flatbuffers::Offset<flatbuffers::Table>(builder.EndTable(start)));
+
+      auto root = flatbuffers::GetRoot<flatbuffers::Table>(
+          builder.GetBufferPointer());
+      auto string_vec = root->GetPointer<
+          const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>*>(
+          flatbuffers::FieldIndexToOffset(0));
+      auto table_vec = root->GetPointer<
+          const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::Table>>*>(
+          flatbuffers::FieldIndexToOffset(1));
+      TEST_EQ(string_vec->size(), 200u);
+      TEST_EQ(table_vec->size(), 200u);
+      for (uint16_t i = 0; i < 200; i++) {
+        TEST_EQ(string_vec->Get(i)->str(), flatbuffers::NumToString(i % 100));
+        TEST_EQ(table_vec->Get(i)->GetField<uint8_t>(
+                    flatbuffers::FieldIndexToOffset(i % 50), 0),
+                1);
+      }
+      // The pool must not survive into the next buffer.
+      builder.Clear();
+    }
+  }
+}
+
+// Builds tables with many distinct (and repeated) vtable layouts, and checks
+// the hashed vtable index dedups them exactly like the linear scan does.
+void HashedVtableDedupTest() {
+  flatbuffers::FlatBufferBuilder linear;
+  flatbuffers::FlatBufferBuilder hashed;
+  hashed.HashVtables(true);
+  for (int pass = 0; pass < 2; pass++) {
+    for (flatbuffers::FlatBufferBuilder* fbb : {&linear, &hashed}) {
+      std::vector<flatbuffers::Offset<flatbuffers::Table>> tables;
+      for (uint32_t repeat = 0; repeat < 2; repeat++) {
+        for (uint32_t fields = 0; fields < 512; fields++) {
+          const auto start = fbb->StartTable();
+          for (uint16_t id = 0; id < 9; id++) {
+            if (fields & (1u << id)) {
+              fbb->AddElement<uint8_t>(flatbuffers::FieldIndexToOffset(id),
+                                       static_cast<uint8_t>(id + repeat), 0);
+            }
+          }
+          tables.push_back(flatbuffers::Offset<flatbuffers::Table>(
+              fbb->EndTable(start)));
+        }
+      }
+      fbb->Finish(fbb->CreateVector(tables));
+    }
+    TEST_EQ(linear.GetSize(), hashed.GetSize());
+    TEST_EQ(memcmp(linear.GetBufferPointer(), hashed.GetBufferPointer(),
+                   linear.GetSize()),
+            0);
+    // The index must be rebuilt from scratch after Clear().
+    linear.Clear();
+    hashed.Clear();
+  }
+}
+
 #if !defined(FLATBUFFERS_USE_STD_SPAN) && !defined(FLATBUFFERS_SPAN_MINIMAL)
 void FlatbuffersSpanTest() {
   // Compile-time checking of non-const [] to const [] conversions.
@@ -1318,6 +1666,191 @@ void SizeVerifierTest() {
   TEST_EQ(length, size_verifier.GetComputedSize());
 }
 
+void BatchVerifierTest() {
+  flatbuffers::FlatBufferBuilder builder;
+  FinishMonsterBuffer(builder,
+                      CreateMonster(builder, nullptr, 0, 0,
+                                    builder.CreateString("BatchMonster")));
+  std::vector<uint8_t> good(builder.GetBufferPointer(),
+                            builder.GetBufferPointer() + builder.GetSize());
+  std::vector<uint8_t> bad_root = good;
+  flatbuffers::WriteScalar<flatbuffers::uoffset_t>(bad_root.data(), 0xFFFF);
+  std::vector<uint8_t> truncated(good.begin(), good.end() - 8);
+
+  // Enough buffers to need more than one result word.
+  const size_t count = 70;
+  std::vector<const uint8_t*> bufs;
+  std::vector<size_t> lens;
+  for (size_t i = 0; i < count; i++) {
+    const std::vector<uint8_t>& buf =
+        i % 7 == 3 ? bad_root : i % 7 == 5 ? truncated : good;
+    bufs.push_back(buf.data());
+    lens.push_back(i == 66 ? 4 : buf.size());
+  }
+  uint64_t results[2];
+  flatbuffers::Verifier verifier(nullptr, 0);
+  const size_t num_valid = verifier.VerifyBuffers<Monster>(
+      bufs.data(), lens.data(), count, MonsterIdentifier(), results);
+  size_t expected_valid = 0;
+  for (size_t i = 0; i < count; i++) {
+    const bool expected = i % 7 != 3 && i % 7 != 5 && i != 66;
+    if (expected) expected_valid++;
+    TEST_EQ(((results[i / 64] >> (i % 64)) & 1) != 0, expected);
+  }
+  TEST_EQ(num_valid, expected_valid);
+  // Bits past the last buffer are left clear.
+  TEST_EQ(results[1] >> (count - 64), 0u);
+
+  // The identifier is checked, too.
+  TEST_EQ(verifier.VerifyBuffers<Monster>(bufs.data(), lens.data(), count,
+                                          "XXXX", results),
+          0u);
+}
+
+void LazyVerifierTest() {
+  flatbuffers::FlatBufferBuilder builder;
+  const auto enemy = CreateMonster(builder, nullptr, 0, 0,
+                                   builder.CreateString("Enemy"));
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  monsters.push_back(CreateMonsterDirect(builder, nullptr, 0, 1, "First"));
+  monsters.push_back(CreateMonsterDirect(builder, nullptr, 0, 2, "Second"));
+  const auto vec = builder.CreateVector(monsters);
+  const auto name = builder.CreateString("Root");
+  MonsterBuilder root_builder(builder);
+  root_builder.add_name(name);
+  root_builder.add_enemy(enemy);
+  root_builder.add_testarrayoftables(vec);
+  FinishMonsterBuffer(builder, root_builder.Finish());
+  std::vector<uint8_t> buf(builder.GetBufferPointer(),
+                           builder.GetBufferPointer() + builder.GetSize());
+
+  // Break the vtable offset of the enemy.
+  const auto enemy_offset = static_cast<size_t>(
+      reinterpret_cast<const uint8_t*>(GetMonster(buf.data())->enemy()) -
+      buf.data());
+  flatbuffers::WriteScalar<flatbuffers::soffset_t>(buf.data() + enemy_offset,
+                                                   0x7FFFFFFF);
+  flatbuffers::Verifier verifier(buf.data(), buf.size());
+  TEST_EQ(VerifyMonsterBuffer(verifier), false);
+
+  for (bool memoize : { false, true }) {
+    flatbuffers::LazyVerifier lazy(buf.data(), buf.size(),
+                                   flatbuffers::LazyVerifier::Options(),
+                                   memoize);
+    // Only the tables that are read are verified.
+    auto root = lazy.GetRoot<Monster>(MonsterIdentifier());
+    TEST_NOTNULL(root);
+    TEST_EQ_STR(root->name()->c_str(), "Root");
+    TEST_ASSERT(!lazy.Verified(root->enemy()));
+    auto tables = root->testarrayoftables();
+    TEST_EQ(tables->size(), 2u);
+    for (int i = 0; i < 2; i++) {
+      auto m = lazy.Verified(tables->Get(i));
+      TEST_NOTNULL(m);
+      TEST_EQ(m->hp(), i + 1);
+      TEST_EQ(lazy.Verified(tables->Get(i)), m);
+    }
+    TEST_ASSERT(!lazy.GetRoot<Monster>("XXXX"));
+  }
+
+  // A table that is valid as one type is not taken as valid when reached as
+  // another type: here a TestSimpleTableWithEnum is also the enemy Monster,
+  // which lacks the required name.
+  flatbuffers::FlatBufferBuilder builder2;
+  const auto simple = CreateTestSimpleTableWithEnum(builder2, Color_Green);
+  const auto name2 = builder2.CreateString("Root");
+  MonsterBuilder root_builder2(builder2);
+  root_builder2.add_name(name2);
+  root_builder2.add_test_type(Any_TestSimpleTableWithEnum);
+  root_builder2.add_test(simple.Union());
+  root_builder2.add_enemy(flatbuffers::Offset<Monster>(simple.o));
+  FinishMonsterBuffer(builder2, root_builder2.Finish());
+  for (bool memoize : { false, true }) {
+    flatbuffers::LazyVerifier lazy(builder2.GetBufferPointer(),
+                                   builder2.GetSize(),
+                                   flatbuffers::LazyVerifier::Options(),
+                                   memoize);
+    auto root = lazy.GetRoot<Monster>(MonsterIdentifier());
+    TEST_NOTNULL(root);
+    auto as_simple = lazy.Verified(root->test_as_TestSimpleTableWithEnum());
+    TEST_NOTNULL(as_simple);
+    TEST_EQ(as_simple->color(), Color_Green);
+    TEST_ASSERT(!lazy.Verified(root->enemy()));
+    TEST_EQ(lazy.Verified(root->test_as_TestSimpleTableWithEnum()),
+            as_simple);
+  }
+}
+
+void ParallelVerifierTest() {
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int i = 0; i < 1000; i++) {
+    monsters.push_back(CreateMonsterDirect(builder, nullptr, 0,
+                                           static_cast<int16_t>(i), "M"));
+  }
+  const auto vec = builder.CreateVector(monsters);
+  const auto name = builder.CreateString("Root");
+  MonsterBuilder root_builder(builder);
+  root_builder.add_name(name);
+  root_builder.add_testarrayoftables(vec);
+  FinishMonsterBuffer(builder, root_builder.Finish());
+  std::vector<uint8_t> buf(builder.GetBufferPointer(),
+                           builder.GetBufferPointer() + builder.GetSize());
+
+  flatbuffers::tests::ThreadedParallelFor threads;
+  flatbuffers::Verifier::Options opts;
+  opts.parallel_min_tables = 100;
+  opts.parallel_for = flatbuffers::tests::ThreadedParallelFor::Run;
+  opts.parallel_for_context = &threads;
+  {
+    flatbuffers::Verifier verifier(buf.data(), buf.size(), opts);
+    TEST_EQ(VerifyMonsterBuffer(verifier), true);
+    TEST_EQ(threads.num_tasks(), 10u);
+  }
+  {
+    flatbuffers::SizeVerifier::Options size_opts;
+    size_opts.parallel_min_tables = opts.parallel_min_tables;
+    size_opts.parallel_for = opts.parallel_for;
+    size_opts.parallel_for_context = opts.parallel_for_context;
+    flatbuffers::SizeVerifier verifier(buf.data(), buf.size(), size_opts);
+    TEST_EQ(VerifyMonsterBuffer(verifier), true);
+    TEST_EQ(verifier.GetComputedSize(), buf.size());
+  }
+  {
+    // The limit on the number of tables covers all tasks together.
+    auto limited_opts = opts;
+    limited_opts.max_tables = 1000;
+    flatbuffers::Verifier verifier(buf.data(), buf.size(), limited_opts);
+    TEST_EQ(VerifyMonsterBuffer(verifier), false);
+    limited_opts.max_tables = 1001;
+    flatbuffers::Verifier verifier2(buf.data(), buf.size(), limited_opts);
+    TEST_EQ(VerifyMonsterBuffer(verifier2), true);
+  }
+  // Break one table at a time, in the first, a middle and the last task, so
+  // a task fails and the vector is verified again serially.
+  for (flatbuffers::uoffset_t i : { 0u, 567u, 999u }) {
+    auto m = GetMonster(buf.data())->testarrayoftables()->Get(i);
+    const auto offset = static_cast<size_t>(
+        reinterpret_cast<const uint8_t*>(m) - buf.data());
+    const auto vtable_offset =
+        flatbuffers::ReadScalar<flatbuffers::soffset_t>(buf.data() + offset);
+    flatbuffers::WriteScalar<flatbuffers::soffset_t>(buf.data() + offset,
+                                                     0x7FFFFFFF);
+    flatbuffers::Verifier verifier(buf.data(), buf.size(), opts);
+    TEST_EQ(VerifyMonsterBuffer(verifier), false);
+    flatbuffers::SizeVerifier::Options size_opts;
+    size_opts.parallel_min_tables = opts.parallel_min_tables;
+    size_opts.parallel_for = opts.parallel_for;
+    size_opts.parallel_for_context = opts.parallel_for_context;
+    flatbuffers::SizeVerifier size_verifier(buf.data(), buf.size(), size_opts);
+    TEST_EQ(VerifyMonsterBuffer(size_verifier), false);
+    flatbuffers::WriteScalar<flatbuffers::soffset_t>(buf.data() + offset,
+                                                     vtable_offset);
+  }
+  flatbuffers::Verifier verifier(buf.data(), buf.size(), opts);
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+}
+
 template <class T, class Container>
 void TestIterators(const std::vector<T>& expected, const Container& tested) {
   TEST_ASSERT(tested.rbegin().base() == tested.end());
@@ -1743,6 +2276,8 @@ int FlatBufferTests(const std::string& tests_data_path) {
   SizePrefixedTest();
 
   AlignmentTest();
+  FixedCreateAlignmentTest();
+  FixedCreateMixedFieldsTest();
 
 #ifndef FLATBUFFERS_NO_FILE_TESTS
   ParseAndGenerateTextTest(tests_data_path, false);
@@ -1750,6 +2285,7 @@ int FlatBufferTests(const std::string& tests_data_path) {
   FixedLengthArrayJsonTest(tests_data_path, false);
   FixedLengthArrayJsonTest(tests_data_path, true);
   ReflectionTest(tests_data_path, flatbuf.data(), flatbuf.size());
+  FlexToFlatTest(tests_data_path);
   ParseProtoTest(tests_data_path);
   EvolutionTest(tests_data_path);
   UnionDeprecationTest(tests_data_path);
@@ -1763,6 +2299,7 @@ int FlatBufferTests(const std::string& tests_data_path) {
   JsonDefaultTest(tests_data_path);
   JsonEnumsTest(tests_data_path);
   TestMonsterExtraFloats(tests_data_path);
+  JsonStreamingTest(tests_data_path);
   ParseIncorrectMonsterJsonTest(tests_data_path);
   FixedLengthArraySpanTest(tests_data_path);
   DoNotRequireEofTest(tests_data_path);
@@ -1774,6 +2311,7 @@ int FlatBufferTests(const std::string& tests_data_path) {
 #endif
 
   UtilConvertCase();
+  StringCompareTest();
 
   FuzzTest1();
   FuzzTest2();
@@ -1792,6 +2330,7 @@ int FlatBufferTests(const std::string& tests_data_path) {
   UnicodeTestAllowNonUTF8();
   UnicodeTestGenerateTextFailsOnNonUTF8();
   UnicodeSurrogatesTest();
+  StringScanningTest();
   UnicodeInvalidSurrogatesTest();
   InvalidUTF8Test();
   UnknownFieldsTest();
@@ -1800,10 +2339,25 @@ int FlatBufferTests(const std::string& tests_data_path) {
   ConformTest();
   ParseProtoBufAsciiTest();
   TypeAliasesTest();
+  EytzingerLayoutTest();
   EndianSwapTest();
+  BulkEndianVectorTest();
   CreateSharedStringTest();
+  SharedStringPoolTest();
+  FlatBufferBuilderPoolTest();
+  SpliceBuilderTest();
+  StreamingBuilderTest();
+  StreamingSharedStringTest();
+  HashedVtableDedupTest();
   FlexBuffersTest();
   FlexBuffersReuseBugTest();
+  FlexBuffersSharedKeyVectorsTest();
+  FlexBuffersMapKeyTest();
+  FlexBuffersStreamingBuilderTest();
+  FlexBuffersCopyToTest();
+  FlexBuffersVerifierReuseTest();
+  FlexBuffersEditableTest();
+  FlexBuffersEditableSharedStringsTest();
   FlexBuffersDeprecatedTest();
   UninitializedVectorTest();
   EqualOperatorTest();
@@ -1820,19 +2374,26 @@ int FlatBufferTests(const std::string& tests_data_path) {
   FixedLengthArrayOperatorEqualTest();
   FieldIdentifierTest();
   StringVectorDefaultsTest();
+  BinaryDefaultsTest();
   FlexBuffersFloatingPointTest();
   FlatbuffersIteratorsTest();
   WarningsAsErrorsTest();
   NestedVerifierTest();
   SizeVerifierTest();
+  BatchVerifierTest();
+  LazyVerifierTest();
+  ParallelVerifierTest();
   PrivateAnnotationsLeaks();
   JsonUnsortedArrayTest();
+  JsonEytzingerArrayTest();
+  JsonDecoderTest();
   VectorSpanTest();
   NativeInlineTableVectorTest();
   FixedSizedScalarKeyInStructTest();
   StructKeyInStructTest();
   NestedStructKeyInStructTest();
   FixedSizedStructArrayKeyInStructTest();
+  EytzingerKeyInGeneratedCodeTest();
   EmbeddedSchemaAccess();
   Offset64Tests();
   UnionUnderlyingTypeTest();
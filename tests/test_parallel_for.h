@@ -0,0 +1,45 @@
+#ifndef TESTS_TEST_PARALLEL_FOR_H
+#define TESTS_TEST_PARALLEL_FOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace flatbuffers {
+namespace tests {
+
+// A `parallel_for` for the verifiers, with a pointer to this as its context,
+// which runs the tasks on `num_threads` threads, each taking the next task
+// nobody has taken yet. Counts the number of tasks asked for.
+class ThreadedParallelFor {
+ public:
+  explicit ThreadedParallelFor(size_t num_threads = 4)
+      : num_threads_(num_threads), num_tasks_(0) {}
+
+  static void Run(void* context, size_t count,
+                  void (*task)(void* task_context, size_t i),
+                  void* task_context) {
+    auto self = static_cast<ThreadedParallelFor*>(context);
+    self->num_tasks_ += count;
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < self->num_threads_; t++) {
+      threads.emplace_back([&]() {
+        for (size_t i = next++; i < count; i = next++) task(task_context, i);
+      });
+    }
+    for (auto& thread : threads) thread.join();
+  }
+
+  size_t num_tasks() const { return num_tasks_; }
+
+ private:
+  size_t num_threads_;
+  size_t num_tasks_;
+};
+
+}  // namespace tests
+}  // namespace flatbuffers
+
+#endif  // TESTS_TEST_PARALLEL_FOR_H
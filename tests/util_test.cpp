@@ -1,5 +1,9 @@
 #include "util_test.h"
 
+#include <iomanip>
+#include <sstream>
+
+#include "flatbuffers/buffer.h"
 #include "flatbuffers/util.h"
 #include "test_assert.h"
 
@@ -42,6 +46,57 @@ void NumericUtilsTest() {
   NumericUtilsTestInteger<int8_t>("-129", "128");
   NumericUtilsTestFloat<float>("-3.4029e+38", "+3.4029e+38");
   NumericUtilsTestFloat<float>("-1.7977e+308", "+1.7977e+308");
+
+  TEST_EQ_STR(NumToString(0).c_str(), "0");
+  TEST_EQ_STR(NumToString(-42).c_str(), "-42");
+  TEST_EQ_STR(NumToString(static_cast<int8_t>(-128)).c_str(), "-128");
+  TEST_EQ_STR(NumToString(flatbuffers::numeric_limits<int64_t>::lowest())
+                  .c_str(),
+              "-9223372036854775808");
+  TEST_EQ_STR(NumToString((flatbuffers::numeric_limits<uint64_t>::max)())
+                  .c_str(),
+              "18446744073709551615");
+
+  // Floats print like std::fixed with trailing zeroes removed.
+  const double doubles[] = { 0.0,   -0.0,    1.0,     -1.5,    0.1,
+                             1e-13, 3.14159, 1e20,    -2e-7,   123456.789,
+                             1e300, 1e-300,  8.5e-12, 65536.0, 1.0 / 3.0 };
+  for (auto d : doubles) {
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(12) << d;
+    auto expected = ss.str();
+    auto p = expected.find_last_not_of('0');
+    expected.resize(p + (expected[p] == '.' ? 2 : 1));
+    TEST_EQ_STR(NumToString(d).c_str(), expected.c_str());
+  }
+  TEST_EQ_STR(NumToString(0.5f).c_str(), "0.5");
+  TEST_EQ_STR(NumToString(3.0f).c_str(), "3.0");
+
+  // Parsing takes the same forms as strtod().
+  double d;
+  TEST_EQ(StringToNumber("+1.5", &d), true);
+  TEST_EQ(d, 1.5);
+  TEST_EQ(StringToNumber("-2.5e-3", &d), true);
+  TEST_EQ(d, -2.5e-3);
+  TEST_EQ(StringToNumber("0x1p-2", &d), true);
+  TEST_EQ(d, 0.25);
+  TEST_EQ(StringToNumber("0.1", &d), true);
+  TEST_EQ(d, 0.1);
+  TEST_EQ(StringToNumber("+-1", &d), false);
+  TEST_EQ(StringToNumber("1.5 ", &d), false);
+  float f;
+  TEST_EQ(StringToNumber("16777217", &f), true);
+  TEST_EQ(f, 16777216.0f);
+  int64_t i64;
+  TEST_EQ(StringToNumber("-000000000000000000042", &i64), true);
+  TEST_EQ(i64, -42);
+  TEST_EQ(StringToNumber("+999999999999999999", &i64), true);
+  TEST_EQ(i64, 999999999999999999);
+  TEST_EQ(StringToNumber("12a", &i64), false);
+  uint64_t u64;
+  TEST_EQ(StringToNumber("9999999999999999999", &u64), true);
+  TEST_EQ(u64, 9999999999999999999u);
+  TEST_EQ(StringToNumber("-1", &u64), false);
 }
 
 void IsAsciiUtilsTest() {
@@ -169,5 +224,29 @@ void UtilConvertCase() {
   }
 }
 
+void StringCompareTest() {
+  const std::string strs[] = {"",
+                              std::string("\0", 1),
+                              "a",
+                              "abcdefg",
+                              "abcdefgh",
+                              std::string("abcdefgh\0001", 10),
+                              "abcdefgh0",
+                              "abcdefgi",
+                              "abcdefgi-0123456789abcdef-0123456789abcdef-1",
+                              "abcdefgi-0123456789abcdef-0123456789abcdef-2",
+                              "\xff"};
+  const size_t num_strs = sizeof(strs) / sizeof(strs[0]);
+  for (size_t i = 0; i < num_strs; i++) {
+    for (size_t j = 0; j < num_strs; j++) {
+      auto cmp = flatbuffers::StringCompare(strs[i].data(), strs[i].size(),
+                                            strs[j].data(), strs[j].size());
+      TEST_EQ(cmp < 0, i < j);
+      TEST_EQ(cmp == 0, i == j);
+      TEST_EQ(cmp > 0, i > j);
+    }
+  }
+}
+
 }  // namespace tests
 }  // namespace flatbuffers